@@ -0,0 +1,333 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Аллокатор поверх malloc/free. Умеет изменять размер блока на месте при помощи realloc,
+// что позволяет RawMemory расти без промежуточного двойного буфера
+template <typename T>
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc не гарантирует такое выравнивание");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* buf = std::malloc(n * sizeof(T));
+        if (!buf) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(buf);
+    }
+
+    void deallocate(T* buf, size_t /*n*/) noexcept {
+        std::free(buf);
+    }
+
+    // При ошибке исходный блок остаётся нетронутым
+    T* reallocate(T* buf, size_t /*old_n*/, size_t new_n) {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* new_buf = std::realloc(buf, new_n * sizeof(T));
+        if (!new_buf) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(new_buf);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+// Аллокатор, выравнивающий буферы по границе Alignment байт (кеш-линия, ширина SIMD-регистра).
+// Vector узнаёт гарантированное выравнивание из alignment и использует выровненные загрузки
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+    static_assert((Alignment & (Alignment - 1)) == 0, "выравнивание должно быть степенью двойки");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        ::operator delete(buf, n * sizeof(T), std::align_val_t{alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+// Аллокатор, размещающий крупные буферы (от threshold байт) в анонимных отображениях mmap,
+// а мелкие — через malloc. Отображения растут при помощи mremap(MREMAP_MAYMOVE): ядро
+// переназначает страницы, не копируя данные и не удваивая пиковое потребление памяти
+template <typename T>
+class MmapAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc не гарантирует такое выравнивание");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t kDefaultThreshold = size_t{4} << 20;
+
+    explicit MmapAllocator(size_t threshold = kDefaultThreshold) noexcept
+        : threshold_(threshold) {
+    }
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>& other) noexcept
+        : threshold_(other.threshold_) {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = ToBytes(n);
+        void* buf = nullptr;
+        if (IsMapped(bytes)) {
+            buf = mmap(nullptr, RoundUpToPage(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buf == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+        } else {
+            buf = std::malloc(bytes);
+            if (!buf) {
+                throw std::bad_alloc();
+            }
+        }
+        return static_cast<T*>(buf);
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            munmap(buf, RoundUpToPage(bytes));
+        } else {
+            std::free(buf);
+        }
+    }
+
+    // При ошибке исходный блок остаётся нетронутым
+    T* reallocate(T* buf, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = ToBytes(new_n);
+        const bool old_mapped = IsMapped(old_bytes);
+        const bool new_mapped = IsMapped(new_bytes);
+        if (!old_mapped && !new_mapped) {
+            void* new_buf = std::realloc(buf, new_bytes);
+            if (!new_buf) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(new_buf);
+        }
+#ifdef __linux__
+        if (old_mapped && new_mapped) {
+            void* new_buf = mremap(buf, RoundUpToPage(old_bytes), RoundUpToPage(new_bytes), MREMAP_MAYMOVE);
+            if (new_buf == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(new_buf);
+        }
+#endif
+        // Переход через порог: блок переносится один раз
+        T* new_buf = allocate(new_n);
+        std::memcpy(new_buf, buf, std::min(old_bytes, new_bytes));
+        deallocate(buf, old_n);
+        return new_buf;
+    }
+
+    size_t Threshold() const noexcept {
+        return threshold_;
+    }
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U>& other) const noexcept {
+        return threshold_ == other.threshold_;
+    }
+
+private:
+    template <typename U>
+    friend class MmapAllocator;
+
+    static size_t ToBytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static size_t RoundUpToPage(size_t bytes) noexcept {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page_size - 1) / page_size * page_size;
+    }
+
+    bool IsMapped(size_t bytes) const noexcept {
+        return bytes >= threshold_;
+    }
+
+    size_t threshold_;
+};
+
+// Аллокатор для крупных буферов горячих данных. Блоки от threshold байт размещаются в анонимных
+// отображениях, выровненных по kHugePageSize, и помечаются madvise(MADV_HUGEPAGE): ядро отдаёт их
+// прозрачными huge pages, что сокращает промахи TLB при последовательном обходе. Мелкие блоки
+// выделяются выровненным operator new. Любой блок выровнен не меньше чем по Alignment байт
+template <typename T, size_t Alignment = 64>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+
+    static_assert((Alignment & (Alignment - 1)) == 0, "выравнивание должно быть степенью двойки");
+    static_assert(alignment <= kHugePageSize);
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, Alignment>;
+    };
+
+    explicit HugePageAllocator(size_t threshold = kHugePageSize) noexcept
+        : threshold_(threshold) {
+    }
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, Alignment>& other) noexcept
+        : threshold_(other.threshold_) {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = ToBytes(n);
+        if (IsMapped(bytes)) {
+            return static_cast<T*>(Map(RoundUpToHugePage(bytes)));
+        }
+        return static_cast<T*>(::operator new(bytes, std::align_val_t{alignment}));
+    }
+
+    void deallocate(T* buf, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            munmap(buf, RoundUpToHugePage(bytes));
+        } else {
+            ::operator delete(buf, bytes, std::align_val_t{alignment});
+        }
+    }
+
+    // При ошибке исходный блок остаётся нетронутым
+    T* reallocate(T* buf, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = ToBytes(new_n);
+#ifdef __linux__
+        if (IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            const size_t old_mapped = RoundUpToHugePage(old_bytes);
+            const size_t new_mapped = RoundUpToHugePage(new_bytes);
+            // Сначала пробуем изменить отображение на месте: адрес и выравнивание сохраняются
+            if (mremap(buf, old_mapped, new_mapped, 0) != MAP_FAILED) {
+                return buf;
+            }
+            // Иначе страницы старого блока переносятся в начало нового выровненного отображения
+            // без копирования данных
+            void* new_buf = Map(new_mapped);
+            if (mremap(buf, old_mapped, old_mapped, MREMAP_MAYMOVE | MREMAP_FIXED, new_buf) == MAP_FAILED) {
+                munmap(new_buf, new_mapped);
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(new_buf);
+        }
+#endif
+        T* new_buf = allocate(new_n);
+        std::memcpy(new_buf, buf, std::min(old_bytes, new_bytes));
+        deallocate(buf, old_n);
+        return new_buf;
+    }
+
+    size_t Threshold() const noexcept {
+        return threshold_;
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, Alignment>& other) const noexcept {
+        return threshold_ == other.threshold_;
+    }
+
+private:
+    template <typename U, size_t A>
+    friend class HugePageAllocator;
+
+    static size_t ToBytes(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - kHugePageSize) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static size_t RoundUpToHugePage(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    // Отображает bytes байт (кратно kHugePageSize) по адресу, кратному kHugePageSize:
+    // отображение с запасом обрезается с обеих сторон
+    static void* Map(size_t bytes) {
+        void* raw = mmap(nullptr, bytes + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const auto begin = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned != begin) {
+            munmap(raw, aligned - begin);
+        }
+        munmap(reinterpret_cast<void*>(aligned + bytes), begin + kHugePageSize - aligned);
+        void* buf = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        // Подсказка необязательна: без поддержки THP блок остаётся на обычных страницах
+        madvise(buf, bytes, MADV_HUGEPAGE);
+#endif
+        return buf;
+    }
+
+    bool IsMapped(size_t bytes) const noexcept {
+        return bytes >= threshold_;
+    }
+
+    size_t threshold_;
+};
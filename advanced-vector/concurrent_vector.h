@@ -0,0 +1,210 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Вектор для одновременного добавления элементов из многих потоков.
+// Элементы хранятся в сегментах RawMemory, размеры которых растут геометрически:
+// сегмент k вмещает kFirstSegmentSize << k элементов. Сегменты никогда не перевыделяются,
+// поэтому адреса элементов стабильны, а ссылки на них остаются действительными до уничтожения вектора.
+// EmplaceBack резервирует слот одним fetch_add и публикует элемент флагом готовности;
+// чтение опубликованных элементов по индексу не требует блокировок
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+    enum class SlotState : unsigned char {
+        kEmpty,
+        kReady,
+        kFailed,  // конструктор элемента бросил исключение, слот не будет опубликован
+    };
+
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<SlotState> state{SlotState::kEmpty};
+
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using Segment = RawMemory<Slot, SlotAlloc>;
+
+public:
+    using allocator_type = Alloc;
+
+    static constexpr size_t kFirstSegmentSize = 32;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector& other) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector& other) = delete;
+
+    ~ConcurrentVector() {
+        const size_t size = size_.load(std::memory_order_acquire);
+        for (size_t k = 0; k < kMaxSegments; ++k) {
+            Slot* slots = segments_[k].load(std::memory_order_acquire);
+            if (!slots) {
+                continue;
+            }
+            const size_t first = SegmentStart(k);
+            const size_t count = first < size ? std::min(SegmentSize(k), size - first) : 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (slots[i].state.load(std::memory_order_relaxed) == SlotState::kReady) {
+                    std::destroy_at(slots[i].Get());
+                }
+            }
+            // Сегмент освобождается тем же RawMemory, что и выделял его
+            Segment segment(slots, SegmentSize(k), SlotAlloc(alloc_));
+        }
+    }
+
+    // Создаёт элемент в новом слоте и публикует его. Слот резервируется без ожидания других потоков;
+    // сегмент создаёт первый обратившийся к нему поток. Если конструктор бросит исключение,
+    // слот останется пустым
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = GetSlot(index);
+        T* elem = nullptr;
+        try {
+            elem = new (slot.storage) T(std::forward<Types>(values)...);
+        } catch (...) {
+            slot.state.store(SlotState::kFailed, std::memory_order_release);
+            throw;
+        }
+        slot.state.store(SlotState::kReady, std::memory_order_release);
+        PrepareNextSegment(index);
+        return *elem;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Число зарезервированных слотов, включая ещё не опубликованные
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Элемент с индексом index или nullptr, если он ещё не опубликован
+    const T* TryGet(size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this).TryGet(index);
+    }
+
+    T* TryGet(size_t index) noexcept {
+        if (index >= Size()) {
+            return nullptr;
+        }
+        const auto [k, offset] = Locate(index);
+        Slot* slots = segments_[k].load(std::memory_order_acquire);
+        if (!slots || slots[offset].state.load(std::memory_order_acquire) != SlotState::kReady) {
+            return nullptr;
+        }
+        return slots[offset].Get();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    // Элемент должен быть уже опубликован
+    T& operator[](size_t index) noexcept {
+        T* elem = TryGet(index);
+        assert(elem);
+        return *elem;
+    }
+
+    // Вызывает f для опубликованных элементов в порядке индексов
+    template <typename F>
+    void ForEach(F&& f) const {
+        const size_t size = Size();
+        for (size_t i = 0; i < size; ++i) {
+            if (const T* elem = TryGet(i)) {
+                f(*elem);
+            }
+        }
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+private:
+    static constexpr size_t kMaxSegments = std::numeric_limits<size_t>::digits
+                                           - std::countr_zero(kFirstSegmentSize);
+
+    static constexpr size_t SegmentSize(size_t k) noexcept {
+        return kFirstSegmentSize << k;
+    }
+
+    // Индекс первого элемента сегмента k
+    static constexpr size_t SegmentStart(size_t k) noexcept {
+        return kFirstSegmentSize * ((size_t{1} << k) - 1);
+    }
+
+    // Номер сегмента и смещение в нём для элемента index
+    static constexpr std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t k = std::bit_width(index / kFirstSegmentSize + 1) - 1;
+        return {k, index - SegmentStart(k)};
+    }
+
+    Slot& GetSlot(size_t index) {
+        const auto [k, offset] = Locate(index);
+        assert(k < kMaxSegments);
+        Slot* slots = segments_[k].load(std::memory_order_acquire);
+        if (!slots) {
+            slots = InstallSegment(k);
+        }
+        return slots[offset];
+    }
+
+    // Поток, занявший середину сегмента, заранее выделяет следующий. Иначе к моменту
+    // заполнения сегмента многие потоки одновременно выделяли бы и размечали новый,
+    // и все копии, кроме одной, выбрасывались бы. Выделение заранее необязательно:
+    // при нехватке памяти сегмент будет выделен при обращении к нему
+    void PrepareNextSegment(size_t index) noexcept {
+        const auto [k, offset] = Locate(index);
+        if (offset != SegmentSize(k) / 2 || k + 1 >= kMaxSegments
+            || segments_[k + 1].load(std::memory_order_relaxed)) {
+            return;
+        }
+        try {
+            InstallSegment(k + 1);
+        } catch (...) {
+        }
+    }
+
+    // Выделяет сегмент и пытается опубликовать его. Проигравший гонку поток освобождает
+    // свой сегмент и использует установленный другим, поэтому каждый поток делает не более одной попытки
+    Slot* InstallSegment(size_t k) {
+        Segment segment(SegmentSize(k), SlotAlloc(alloc_));
+        std::uninitialized_default_construct_n(segment.GetAddress(), SegmentSize(k));
+        Slot* expected = nullptr;
+        if (segments_[k].compare_exchange_strong(expected, segment.GetAddress(), std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+            return segment.Release();
+        }
+        return expected;
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    // Счётчик слотов изменяется всеми потоками, поэтому занимает отдельную кеш-линию
+    alignas(64) std::atomic<size_t> size_{0};
+    alignas(64) std::atomic<Slot*> segments_[kMaxSegments] = {};
+};
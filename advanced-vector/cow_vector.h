@@ -0,0 +1,347 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+template <typename T, typename Alloc>
+class CowSnapshot;
+
+namespace detail {
+
+// Блок с элементами и счётчиком владельцев, общий для копий CowVector и снимков
+template <typename T, typename Alloc>
+struct CowBlock {
+    template <typename... Args>
+    explicit CowBlock(Args&&... args)
+        : data(std::forward<Args>(args)...) {
+    }
+
+    std::atomic<size_t> owners{1};
+    Vector<T, Alloc> data;
+};
+
+// Владеющая ссылка на CowBlock. Счётчик изменяется атомарно, поэтому ссылки на один блок
+// можно копировать и уничтожать в разных потоках
+template <typename T, typename Alloc>
+class CowRef {
+public:
+    using Block = CowBlock<T, Alloc>;
+
+    CowRef() = default;
+
+    explicit CowRef(Block* block) noexcept
+        : block_(block) {
+    }
+
+    CowRef(const CowRef& other) noexcept
+        : block_(other.block_) {
+        if (block_) {
+            block_->owners.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowRef(CowRef&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    CowRef& operator=(CowRef rhs) noexcept {
+        std::swap(block_, rhs.block_);
+        return *this;
+    }
+
+    // Последний владелец видит все записи, сделанные до освобождения другими владельцами
+    ~CowRef() {
+        if (block_ && block_->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block_;
+        }
+    }
+
+    // Ссылка единственная: блок можно изменять без копирования
+    bool IsUnique() const noexcept {
+        return block_->owners.load(std::memory_order_acquire) == 1;
+    }
+
+    Block* Get() const noexcept {
+        return block_;
+    }
+
+    void Swap(CowRef& other) noexcept {
+        std::swap(block_, other.block_);
+    }
+
+private:
+    Block* block_ = nullptr;
+};
+
+}  // namespace detail
+
+// Вектор с разделяемым при копировании буфером. Копии и снимки ссылаются на один блок
+// со счётчиком владельцев; блок копируется лишь при первом изменении разделяемого вектора
+// (неконстантные operator[], begin/end, EmplaceBack, Erase и др.). Копирование, снимок и их
+// уничтожение занимают O(1), поэтому передать большой вектор многим читателям дёшево.
+// Неконстантные operator[], begin/end, EmplaceBack и Erase выдают ссылки, через которые блок можно
+// изменить и позже, поэтому после них вектор считается «выданным»: копии и снимки копируют элементы,
+// пока Clear или присваивание не заменят блок. Set изменяет элемент, не выдавая ссылку.
+// Разные объекты с общим блоком можно использовать из разных потоков; один объект,
+// как и Vector, нельзя изменять одновременно с другими обращениями к нему
+template <typename T, typename Alloc = std::allocator<T>>
+class CowVector {
+    using Block = detail::CowBlock<T, Alloc>;
+    using Ref = detail::CowRef<T, Alloc>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+
+    CowVector() = default;
+
+    // Копия разделяет блок, если через other не выдавались ссылки на изменение
+    CowVector(const CowVector& other)
+        : ref_(other.ShareableRef()) {
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : ref_(std::move(other.ref_))
+        , leaked_(std::exchange(other.leaked_, false)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) {
+        if (this != &rhs) {
+            ref_ = rhs.ShareableRef();
+            leaked_ = false;
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            CowVector moved(std::move(rhs));
+            Swap(moved);
+        }
+        return *this;
+    }
+
+    explicit CowVector(size_t size, const Alloc& alloc = Alloc())
+        : ref_(new Block(size, alloc)) {
+    }
+
+    // Забирает элементы vector без копирования
+    explicit CowVector(Vector<T, Alloc>&& vector)
+        : ref_(new Block(std::move(vector))) {
+    }
+
+    explicit CowVector(const Vector<T, Alloc>& vector)
+        : ref_(new Block(vector)) {
+    }
+
+    // Начинает разделять блок снимка
+    explicit CowVector(const CowSnapshot<T, Alloc>& snapshot) noexcept
+        : ref_(snapshot.ref_) {
+    }
+
+    // Неизменяемый снимок текущего содержимого за O(1), а у «выданного» вектора — копия
+    // элементов. Последующие изменения вектора копируют блок и не видны в снимке
+    CowSnapshot<T, Alloc> Snapshot() const {
+        return CowSnapshot<T, Alloc>(ShareableRef());
+    }
+
+    const_iterator begin() const noexcept {
+        return Read().begin();
+    }
+
+    const_iterator end() const noexcept {
+        return Read().end();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Неконстантный доступ делает буфер собственным и «выданным»
+    iterator begin() {
+        return WriteLeaked().begin();
+    }
+
+    iterator end() {
+        return WriteLeaked().end();
+    }
+
+    size_t Size() const noexcept {
+        return Read().Size();
+    }
+
+    size_t Capacity() const noexcept {
+        return Read().Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return Read()[index];
+    }
+
+    T& operator[](size_t index) {
+        return WriteLeaked()[index];
+    }
+
+    // Заменяет элемент, не выдавая ссылку на него: копии и снимки по-прежнему разделяют блок
+    template <typename U>
+    void Set(size_t index, U&& value) {
+        Write()[index] = std::forward<U>(value);
+    }
+
+    // Доступ ко всем константным операциям Vector (Find, Count, Sum и т.д.)
+    const Vector<T, Alloc>& Get() const noexcept {
+        return Read();
+    }
+
+    void Reserve(size_t new_capacity) {
+        Write(new_capacity).Reserve(new_capacity);
+    }
+
+    void Resize(size_t new_size) {
+        Write(new_size).Resize(new_size);
+    }
+
+    // Аргументы могут ссылаться на элементы вектора
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        T& elem = Append(std::forward<Types>(values)...);
+        leaked_ = true;
+        return elem;
+    }
+
+    void PushBack(const T& value) {
+        Append(value);
+    }
+
+    void PushBack(T&& value) {
+        Append(std::move(value));
+    }
+
+    void PopBack() {
+        Write().PopBack();
+    }
+
+    iterator Erase(const_iterator cpos) {
+        const size_t index = cpos - cbegin();
+        Vector<T, Alloc>& data = WriteLeaked();
+        return data.Erase(data.begin() + index);
+    }
+
+    // Разделяемый буфер не копируется, а отпускается. Выданные ссылки становятся недействительными
+    void Clear() noexcept {
+        if (IsShared()) {
+            ref_ = Ref();
+        } else if (ref_.Get()) {
+            ref_.Get()->data.Clear();
+        }
+        leaked_ = false;
+    }
+
+    // Буфер разделён с другими векторами или снимками
+    bool IsShared() const noexcept {
+        return ref_.Get() && !ref_.IsUnique();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        ref_.Swap(other.ref_);
+        std::swap(leaked_, other.leaked_);
+    }
+
+private:
+    friend class CowSnapshot<T, Alloc>;
+
+    static const Vector<T, Alloc>& Empty() noexcept {
+        static const Vector<T, Alloc> empty;
+        return empty;
+    }
+
+    const Vector<T, Alloc>& Read() const noexcept {
+        return ref_.Get() ? ref_.Get()->data : Empty();
+    }
+
+    // Делает блок собственным, копируя его, если он разделён. Копия получает
+    // вместимость не меньше capacity, чтобы следующая операция не перевыделяла память
+    Vector<T, Alloc>& Write(size_t capacity = 0) {
+        if (!ref_.Get()) {
+            ref_ = Ref(new Block());
+        } else if (!ref_.IsUnique()) {
+            const Vector<T, Alloc>& source = ref_.Get()->data;
+            Ref copy(new Block(source.GetAllocator()));
+            copy.Get()->data.Reserve(std::max(capacity, source.Size()));
+            copy.Get()->data.Append(source.begin(), source.end());
+            ref_ = std::move(copy);
+        }
+        return ref_.Get()->data;
+    }
+
+    // Через выданные ссылки можно изменить блок, поэтому его нельзя разделять
+    Ref ShareableRef() const {
+        return leaked_ ? Ref(new Block(Read())) : ref_;
+    }
+
+    // Вызывающий получит ссылку в блок
+    Vector<T, Alloc>& WriteLeaked() {
+        Vector<T, Alloc>& data = Write();
+        leaked_ = true;
+        return data;
+    }
+
+    // Аргументы могут ссылаться на элементы разделяемого блока: он удерживается до создания элемента
+    template <typename... Types>
+    T& Append(Types&&... values) {
+        const Ref shared = IsShared() ? ref_ : Ref();
+        return Write(std::max(Capacity(), Size() + 1)).EmplaceBack(std::forward<Types>(values)...);
+    }
+
+    Ref ref_;
+    // Выдавались неконстантные ссылки или итераторы; такой блок всегда единственный
+    bool leaked_ = false;
+};
+
+// Неизменяемый снимок CowVector: разделяет блок с вектором и копируется за O(1)
+template <typename T, typename Alloc = std::allocator<T>>
+class CowSnapshot {
+public:
+    using const_iterator = const T*;
+
+    CowSnapshot() = default;
+
+    const_iterator begin() const noexcept {
+        return Get().begin();
+    }
+
+    const_iterator end() const noexcept {
+        return Get().end();
+    }
+
+    size_t Size() const noexcept {
+        return Get().Size();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return Get()[index];
+    }
+
+    const Vector<T, Alloc>& Get() const noexcept {
+        return ref_.Get() ? ref_.Get()->data : CowVector<T, Alloc>::Empty();
+    }
+
+private:
+    friend class CowVector<T, Alloc>;
+
+    explicit CowSnapshot(const detail::CowRef<T, Alloc>& ref) noexcept
+        : ref_(ref) {
+    }
+
+    detail::CowRef<T, Alloc> ref_;
+};
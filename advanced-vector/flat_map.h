@@ -0,0 +1,561 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Ассоциативные контейнеры, хранящие ключи и значения подряд в Vector, а не в отдельных узлах.
+// SortedFlatSet и SortedFlatMap держат элементы отсортированными и ищут двоичным поиском;
+// вставка и удаление сдвигают хвост средствами Vector. FlatHashSet и FlatHashMap хранят элементы
+// в порядке вставки, а поиск ведут по открытой адресации: байты контроля группы из 16 ячеек
+// сравниваются с 7 битами хеша за одну SIMD-инструкцию. Указатели на элементы и значения
+// действительны до следующей вставки или удаления
+
+namespace detail {
+
+template <typename Key>
+struct SetPolicy {
+    using Entry = Key;
+
+    static const Key& KeyOf(const Entry& entry) noexcept {
+        return entry;
+    }
+
+    // Аргументы конструктора элемента; временные кортежи живут до конца полного выражения
+    template <typename K>
+    static auto EntryArgs(K&& key) noexcept {
+        return std::forward_as_tuple(std::forward<K>(key));
+    }
+};
+
+template <typename Key, typename Value>
+struct MapPolicy {
+    using Entry = std::pair<Key, Value>;
+
+    static const Key& KeyOf(const Entry& entry) noexcept {
+        return entry.first;
+    }
+
+    template <typename K, typename... Args>
+    static auto EntryArgs(K&& key, Args&&... args) noexcept {
+        return std::make_tuple(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+};
+
+// Общая часть SortedFlatSet и SortedFlatMap: элементы в Vector, упорядоченные по ключу
+template <typename Policy, typename Compare>
+class SortedTable {
+public:
+    using Entry = typename Policy::Entry;
+    using const_iterator = const Entry*;
+
+    SortedTable() = default;
+
+    // Сортирует entries и за один проход удаляет повторы ключей; из повторов остаётся первый
+    explicit SortedTable(Vector<Entry> entries, const Compare& compare = Compare())
+        : entries_(std::move(entries))
+        , compare_(compare) {
+        const auto less = [this](const Entry& lhs, const Entry& rhs) {
+            return compare_(Policy::KeyOf(lhs), Policy::KeyOf(rhs));
+        };
+        std::stable_sort(entries_.begin(), entries_.end(), less);
+        const auto duplicate = [&less](const Entry& lhs, const Entry& rhs) {
+            return !less(lhs, rhs);
+        };
+        entries_.EraseRange(std::unique(entries_.begin(), entries_.end(), duplicate), entries_.end());
+    }
+
+    const_iterator begin() const noexcept {
+        return entries_.Data();
+    }
+
+    const_iterator end() const noexcept {
+        return entries_.Data() + entries_.Size();
+    }
+
+    size_t Size() const noexcept {
+        return entries_.Size();
+    }
+
+    bool IsEmpty() const noexcept {
+        return entries_.Size() == 0;
+    }
+
+    void Reserve(size_t capacity) {
+        entries_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        entries_.Clear();
+    }
+
+    const Vector<Entry>& Entries() const noexcept {
+        return entries_;
+    }
+
+    template <typename K>
+    bool Contains(const K& key) const {
+        return FindEntry(key) != nullptr;
+    }
+
+    template <typename K>
+    bool Erase(const K& key) {
+        const Entry* pos = LowerBound(key);
+        if (!Matches(pos, key)) {
+            return false;
+        }
+        entries_.Erase(entries_.begin() + (pos - begin()));
+        return true;
+    }
+
+protected:
+    template <typename K>
+    Entry* FindEntry(const K& key) {
+        Entry* pos = entries_.Data() + (LowerBound(key) - begin());
+        return Matches(pos, key) ? pos : nullptr;
+    }
+
+    template <typename K>
+    const Entry* FindEntry(const K& key) const {
+        return const_cast<SortedTable&>(*this).FindEntry(key);
+    }
+
+    // Вставляет элемент, если ключа ещё нет. Возвращает элемент с этим ключом и признак вставки
+    template <typename K, typename... Args>
+    std::pair<Entry*, bool> TryEmplace(K&& key, Args&&... args) {
+        const size_t index = LowerBound(key) - begin();
+        if (Matches(begin() + index, key)) {
+            return {entries_.Data() + index, false};
+        }
+        std::apply(
+            [this, index](auto&&... values) {
+                entries_.Emplace(entries_.begin() + index, std::forward<decltype(values)>(values)...);
+            },
+            Policy::EntryArgs(std::forward<K>(key), std::forward<Args>(args)...));
+        return {entries_.Data() + index, true};
+    }
+
+private:
+    template <typename K>
+    const Entry* LowerBound(const K& key) const {
+        return std::lower_bound(begin(), end(), key, [this](const Entry& entry, const K& k) {
+            return compare_(Policy::KeyOf(entry), k);
+        });
+    }
+
+    template <typename K>
+    bool Matches(const Entry* pos, const K& key) const {
+        return pos != end() && !compare_(key, Policy::KeyOf(*pos));
+    }
+
+    Vector<Entry> entries_;
+    [[no_unique_address]] Compare compare_;
+};
+
+// Байты контроля: пустая ячейка, удалённая ячейка или 7 младших битов хеша занятой ячейки.
+// У свободных ячеек установлен старший бит, у занятых — сброшен
+inline constexpr int8_t kCtrlEmpty = -128;
+inline constexpr int8_t kCtrlDeleted = -2;
+inline constexpr size_t kCtrlGroup = 16;
+
+// Битовая маска ячеек группы, байт контроля которых равен ctrl
+inline uint32_t MatchCtrl(const int8_t* group, int8_t ctrl) noexcept {
+#if defined(__SSE2__)
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(ctrl))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kCtrlGroup; ++i) {
+        mask |= uint32_t{group[i] == ctrl} << i;
+    }
+    return mask;
+#endif
+}
+
+// Маска пустых и удалённых ячеек — это знаковые биты байтов контроля
+inline uint32_t MatchFree(const int8_t* group) noexcept {
+#if defined(__SSE2__)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kCtrlGroup; ++i) {
+        mask |= uint32_t{group[i] < 0} << i;
+    }
+    return mask;
+#endif
+}
+
+// Перемешивает биты: std::hash для целых — тождественная функция, а индекс группы и байт
+// контроля берутся из разных частей хеша
+inline size_t MixHash(size_t hash) noexcept {
+    const uint64_t h = (static_cast<uint64_t>(hash) ^ (static_cast<uint64_t>(hash) >> 32)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+// Общая часть FlatHashSet и FlatHashMap. Элементы лежат подряд в entries_ в порядке вставки,
+// таблица ctrl_ и index_ хранит для каждой ячейки байт контроля и номер элемента.
+// Удаление переносит последний элемент на место удалённого, поэтому entries_ остаётся без дыр,
+// а при росте таблица строится заново по entries_ без переноса самих элементов
+template <typename Policy, typename Hash, typename KeyEqual>
+class HashTable {
+    static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+    // Результат осмотра группы, после которого пробы продолжаются в следующей
+    static constexpr size_t kNextGroup = kNotFound - 1;
+
+public:
+    using Entry = typename Policy::Entry;
+    using const_iterator = const Entry*;
+
+    HashTable() = default;
+
+    HashTable(const HashTable&) = default;
+    HashTable& operator=(const HashTable&) = default;
+
+    // Оставляет other пустым и без таблицы
+    HashTable(HashTable&& other) noexcept
+        : entries_(std::move(other.entries_))
+        , ctrl_(std::move(other.ctrl_))
+        , index_(std::move(other.index_))
+        , growth_left_(std::exchange(other.growth_left_, 0))
+        , hash_(std::move(other.hash_))
+        , equal_(std::move(other.equal_)) {
+    }
+
+    HashTable& operator=(HashTable&& rhs) noexcept {
+        if (this != &rhs) {
+            HashTable moved(std::move(rhs));
+            entries_.Swap(moved.entries_);
+            ctrl_.Swap(moved.ctrl_);
+            index_.Swap(moved.index_);
+            std::swap(growth_left_, moved.growth_left_);
+            std::swap(hash_, moved.hash_);
+            std::swap(equal_, moved.equal_);
+        }
+        return *this;
+    }
+
+    explicit HashTable(Vector<Entry> entries, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual())
+        : hash_(hash)
+        , equal_(equal) {
+        Reserve(entries.Size());
+        for (Entry& entry : entries) {
+            const Entry& e = entry;
+            if (FindSlot(Policy::KeyOf(e)) == kNotFound) {
+                Place(std::move(entry));
+            }
+        }
+    }
+
+    const_iterator begin() const noexcept {
+        return entries_.Data();
+    }
+
+    const_iterator end() const noexcept {
+        return entries_.Data() + entries_.Size();
+    }
+
+    size_t Size() const noexcept {
+        return entries_.Size();
+    }
+
+    bool IsEmpty() const noexcept {
+        return entries_.Size() == 0;
+    }
+
+    // Число ячеек таблицы; заполняется не больше 7/8 из них
+    size_t BucketCount() const noexcept {
+        return index_.Size();
+    }
+
+    // Готовит место для size элементов без перестроения таблицы
+    void Reserve(size_t size) {
+        entries_.Reserve(size);
+        const size_t buckets = std::bit_ceil(std::max(kCtrlGroup, size + size / 7 + 1));
+        if (buckets > BucketCount()) {
+            Rehash(buckets);
+        }
+    }
+
+    // Таблица сохраняет размер
+    void Clear() noexcept {
+        entries_.Clear();
+        std::fill(ctrl_.begin(), ctrl_.end(), kCtrlEmpty);
+        growth_left_ = MaxLoad(BucketCount());
+    }
+
+    const Vector<Entry>& Entries() const noexcept {
+        return entries_;
+    }
+
+    template <typename K>
+    bool Contains(const K& key) const {
+        return FindSlot(key) != kNotFound;
+    }
+
+    template <typename K>
+    bool Erase(const K& key) {
+        const size_t slot = FindSlot(key);
+        if (slot == kNotFound) {
+            return false;
+        }
+        // Ячейка становится удалённой: цепочки проб через неё не должны обрываться
+        ctrl_[slot] = kCtrlDeleted;
+        const size_t index = index_[slot];
+        const size_t last = entries_.Size() - 1;
+        if (index != last) {
+            index_[FindIndexSlot(last)] = static_cast<uint32_t>(index);
+        }
+        entries_.EraseUnordered(entries_.begin() + index);
+        return true;
+    }
+
+protected:
+    template <typename K>
+    Entry* FindEntry(const K& key) {
+        const size_t slot = FindSlot(key);
+        return slot == kNotFound ? nullptr : entries_.Data() + index_[slot];
+    }
+
+    template <typename K>
+    const Entry* FindEntry(const K& key) const {
+        return const_cast<HashTable&>(*this).FindEntry(key);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<Entry*, bool> TryEmplace(K&& key, Args&&... args) {
+        if (Entry* entry = FindEntry(key)) {
+            return {entry, false};
+        }
+        if (growth_left_ == 0) {
+            Grow();
+        }
+        std::apply(
+            [this](auto&&... values) {
+                Place(std::forward<decltype(values)>(values)...);
+            },
+            Policy::EntryArgs(std::forward<K>(key), std::forward<Args>(args)...));
+        return {&entries_[entries_.Size() - 1], true};
+    }
+
+private:
+    static size_t MaxLoad(size_t buckets) noexcept {
+        return buckets - buckets / 8;
+    }
+
+    size_t GroupMask() const noexcept {
+        return BucketCount() / kCtrlGroup - 1;
+    }
+
+    size_t HashOf(const auto& key) const {
+        return MixHash(hash_(key));
+    }
+
+    static int8_t CtrlOf(size_t hash) noexcept {
+        return static_cast<int8_t>(hash & 0x7F);
+    }
+
+    // Группы перебираются с шагами 1, 2, 3, ...: при числе групп, равном степени двойки,
+    // такая последовательность обходит каждую группу ровно один раз
+    template <typename F>
+    size_t Probe(size_t hash, F&& visit) const {
+        const size_t mask = GroupMask();
+        size_t group = (hash >> 7) & mask;
+        for (size_t step = 1;; ++step) {
+            if (const size_t slot = visit(group * kCtrlGroup); slot != kNextGroup) {
+                return slot;
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    template <typename K>
+    size_t FindSlot(const K& key) const {
+        if (BucketCount() == 0) {
+            return kNotFound;
+        }
+        const size_t hash = HashOf(key);
+        return Probe(hash, [&](size_t first) {
+            const int8_t* group = ctrl_.Data() + first;
+            for (uint32_t mask = MatchCtrl(group, CtrlOf(hash)); mask != 0; mask &= mask - 1) {
+                const size_t slot = first + std::countr_zero(mask);
+                if (equal_(Policy::KeyOf(entries_[index_[slot]]), key)) {
+                    return slot;
+                }
+            }
+            // Вставка заняла бы пустую ячейку группы, поэтому дальше ключа быть не может
+            return MatchCtrl(group, kCtrlEmpty) != 0 ? kNotFound : kNextGroup;
+        });
+    }
+
+    // Ячейка, ссылающаяся на элемент index
+    size_t FindIndexSlot(size_t index) const {
+        const size_t hash = HashOf(Policy::KeyOf(entries_[index]));
+        return Probe(hash, [&](size_t first) {
+            for (uint32_t mask = MatchCtrl(ctrl_.Data() + first, CtrlOf(hash)); mask != 0; mask &= mask - 1) {
+                const size_t slot = first + std::countr_zero(mask);
+                if (index_[slot] == index) {
+                    return slot;
+                }
+            }
+            return kNextGroup;
+        });
+    }
+
+    // Первая свободная ячейка на пути проб хеша
+    size_t FindFreeSlot(size_t hash) const {
+        return Probe(hash, [&](size_t first) {
+            const uint32_t mask = MatchFree(ctrl_.Data() + first);
+            return mask != 0 ? first + std::countr_zero(mask) : kNextGroup;
+        });
+    }
+
+    void Link(size_t index, size_t hash) noexcept {
+        const size_t slot = FindFreeSlot(hash);
+        if (ctrl_[slot] == kCtrlEmpty) {
+            --growth_left_;
+        }
+        ctrl_[slot] = CtrlOf(hash);
+        index_[slot] = static_cast<uint32_t>(index);
+    }
+
+    // Добавляет элемент в конец entries_ и ячейку для него. Место в таблице уже должно быть
+    template <typename... Args>
+    void Place(Args&&... args) {
+        if (entries_.Size() == std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("HashTable: too many elements");
+        }
+        const Entry& entry = entries_.EmplaceBack(std::forward<Args>(args)...);
+        Link(entries_.Size() - 1, HashOf(Policy::KeyOf(entry)));
+    }
+
+    // Удвоение, если живые элементы занимают больше половины допустимой загрузки;
+    // иначе места не хватает из-за удалённых ячеек, и таблица перестраивается того же размера
+    void Grow() {
+        const size_t buckets = BucketCount();
+        Rehash(buckets == 0 ? kCtrlGroup : Size() * 2 > MaxLoad(buckets) ? buckets * 2 : buckets);
+    }
+
+    void Rehash(size_t buckets) {
+        Vector<int8_t> ctrl(buckets);
+        Vector<uint32_t> index(buckets, default_init);
+        std::fill(ctrl.begin(), ctrl.end(), kCtrlEmpty);
+        ctrl_.Swap(ctrl);
+        index_.Swap(index);
+        growth_left_ = MaxLoad(buckets);
+        for (size_t i = 0; i < entries_.Size(); ++i) {
+            Link(i, HashOf(Policy::KeyOf(entries_[i])));
+        }
+    }
+
+    Vector<Entry> entries_;
+    Vector<int8_t> ctrl_;
+    Vector<uint32_t> index_;
+    size_t growth_left_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] KeyEqual equal_;
+};
+
+}  // namespace detail
+
+template <typename Key, typename Compare = std::less<>>
+class SortedFlatSet : public detail::SortedTable<detail::SetPolicy<Key>, Compare> {
+    using Base = detail::SortedTable<detail::SetPolicy<Key>, Compare>;
+
+public:
+    using Base::Base;
+
+    // Возвращает false, если ключ уже есть
+    template <typename K>
+    bool Insert(K&& key) {
+        return Base::TryEmplace(std::forward<K>(key)).second;
+    }
+};
+
+template <typename Key, typename Value, typename Compare = std::less<>>
+class SortedFlatMap : public detail::SortedTable<detail::MapPolicy<Key, Value>, Compare> {
+    using Base = detail::SortedTable<detail::MapPolicy<Key, Value>, Compare>;
+
+public:
+    using Base::Base;
+
+    // Значение по ключу или nullptr
+    template <typename K>
+    Value* Find(const K& key) {
+        auto* entry = Base::FindEntry(key);
+        return entry ? &entry->second : nullptr;
+    }
+
+    template <typename K>
+    const Value* Find(const K& key) const {
+        return const_cast<SortedFlatMap&>(*this).Find(key);
+    }
+
+    // Создаёт значение из args, если ключа ещё нет; иначе args не используются
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> Emplace(K&& key, Args&&... args) {
+        auto [entry, inserted] = Base::TryEmplace(std::forward<K>(key), std::forward<Args>(args)...);
+        return {&entry->second, inserted};
+    }
+
+    template <typename K>
+    Value& operator[](K&& key) {
+        return *Emplace(std::forward<K>(key)).first;
+    }
+};
+
+template <typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatHashSet : public detail::HashTable<detail::SetPolicy<Key>, Hash, KeyEqual> {
+    using Base = detail::HashTable<detail::SetPolicy<Key>, Hash, KeyEqual>;
+
+public:
+    using Base::Base;
+
+    template <typename K>
+    bool Insert(K&& key) {
+        return Base::TryEmplace(std::forward<K>(key)).second;
+    }
+};
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<>>
+class FlatHashMap : public detail::HashTable<detail::MapPolicy<Key, Value>, Hash, KeyEqual> {
+    using Base = detail::HashTable<detail::MapPolicy<Key, Value>, Hash, KeyEqual>;
+
+public:
+    using Base::Base;
+
+    template <typename K>
+    Value* Find(const K& key) {
+        auto* entry = Base::FindEntry(key);
+        return entry ? &entry->second : nullptr;
+    }
+
+    template <typename K>
+    const Value* Find(const K& key) const {
+        return const_cast<FlatHashMap&>(*this).Find(key);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> Emplace(K&& key, Args&&... args) {
+        auto [entry, inserted] = Base::TryEmplace(std::forward<K>(key), std::forward<Args>(args)...);
+        return {&entry->second, inserted};
+    }
+
+    template <typename K>
+    Value& operator[](K&& key) {
+        return *Emplace(std::forward<K>(key)).first;
+    }
+};
@@ -0,0 +1,355 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Вектор с буфером-разрывом (gap buffer): свободная вместимость хранится не в конце, а в позиции
+// последней вставки или удаления. Элементы [0, gap_begin_) лежат в начале буфера, остальные —
+// в его конце, за разрывом. Вставка и удаление в позиции разрыва занимают O(1), а перенос разрыва
+// на k позиций — O(k), поэтому серия правок рядом с одним местом (например, ввод текста
+// в редакторе) стоит O(1) амортизированно. Позиции задаются индексами: перенос разрыва
+// перемещает элементы, и указатели на них становятся недействительными
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+class GapVector {
+    // Разрыв переносится без возможности откатить перенос при исключении
+    static_assert(detail::kNothrowRelocate<T>, "элементы GapVector должны переноситься без исключений");
+
+    using Buffer = RawMemory<T, Alloc>;
+
+    template <bool Const>
+    class Iterator;
+
+public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using allocator_type = Alloc;
+
+    GapVector() = default;
+
+    explicit GapVector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    explicit GapVector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc) {
+        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        gap_begin_ = gap_end_ = size;
+    }
+
+    // Копия хранит элементы подряд, разрыв — в конце
+    GapVector(const GapVector& other)
+        : GapVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator())) {
+        Buffer data(other.Size(), data_.GetAllocator());
+        T* to = data.GetAddress();
+        std::uninitialized_copy_n(other.data_.GetAddress(), other.gap_begin_, to);
+        try {
+            std::uninitialized_copy(other.data_ + other.gap_end_, other.data_ + other.Capacity(), to + other.gap_begin_);
+        } catch (...) {
+            std::destroy_n(to, other.gap_begin_);
+            throw;
+        }
+        data_.Swap(data);
+        gap_begin_ = gap_end_ = other.Size();
+    }
+
+    GapVector(GapVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , gap_begin_(std::exchange(other.gap_begin_, 0))
+        , gap_end_(std::exchange(other.gap_end_, 0)) {
+    }
+
+    GapVector& operator=(const GapVector& rhs) {
+        if (this != &rhs) {
+            GapVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    GapVector& operator=(GapVector&& rhs) noexcept {
+        if (this != &rhs) {
+            GapVector old(std::move(*this));
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~GapVector() {
+        Clear();
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, Size());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, Size());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return Capacity() - GapSize();
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Индекс, перед которым сейчас находится разрыв
+    size_t GapPosition() const noexcept {
+        return gap_begin_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<GapVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return *Address(index);
+    }
+
+    // Увеличивает разрыв, оставляя его на прежнем месте
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    // Аргументы могут ссылаться на элементы вектора
+    template <typename... Types>
+    T& Emplace(size_t index, Types&&... values) {
+        assert(index <= Size());
+        if (index == gap_begin_ && GapSize() != 0) {
+            return ConstructInGap(std::forward<Types>(values)...);
+        }
+        // Перенос разрыва или рост буфера переместят элементы, на которые ссылаются аргументы
+        T tmp(std::forward<Types>(values)...);
+        if (GapSize() == 0) {
+            Reallocate(Growth::NextCapacity(Capacity(), Size() + 1, sizeof(T)));
+        }
+        MoveGapTo(index);
+        return ConstructInGap(std::move(tmp));
+    }
+
+    void Insert(size_t index, const T& value) {
+        Emplace(index, value);
+    }
+
+    void Insert(size_t index, T&& value) {
+        Emplace(index, std::move(value));
+    }
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        return Emplace(Size(), std::forward<Types>(values)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        Erase(Size() - 1);
+    }
+
+    // Удаляет элемент index; разрыв оказывается на его месте
+    void Erase(size_t index) noexcept {
+        EraseRange(index, index + 1);
+    }
+
+    void EraseRange(size_t first, size_t last) noexcept {
+        assert(first <= last && last <= Size());
+        MoveGapTo(first);
+        std::destroy_n(data_ + gap_end_, last - first);
+        gap_end_ += last - first;
+    }
+
+    // Вместимость сохраняется
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), gap_begin_);
+        std::destroy(data_ + gap_end_, data_ + Capacity());
+        gap_begin_ = 0;
+        gap_end_ = Capacity();
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    void Swap(GapVector& other) noexcept {
+        data_.Swap(other.data_);
+        std::swap(gap_begin_, other.gap_begin_);
+        std::swap(gap_end_, other.gap_end_);
+    }
+
+private:
+    size_t GapSize() const noexcept {
+        return gap_end_ - gap_begin_;
+    }
+
+    T* Address(size_t index) noexcept {
+        return data_ + (index < gap_begin_ ? index : index + GapSize());
+    }
+
+    template <typename... Types>
+    T& ConstructInGap(Types&&... values) {
+        T* elem = std::construct_at(data_ + gap_begin_, std::forward<Types>(values)...);
+        ++gap_begin_;
+        return *elem;
+    }
+
+    // Переносит элементы между index и разрывом на другую его сторону
+    void MoveGapTo(size_t index) noexcept {
+        if (index < gap_begin_) {
+            const size_t count = gap_begin_ - index;
+            detail::RelocateOverlapping(data_ + index, count, data_ + gap_end_ - count);
+            gap_begin_ -= count;
+            gap_end_ -= count;
+        } else if (index > gap_begin_) {
+            const size_t count = index - gap_begin_;
+            detail::RelocateOverlapping(data_ + gap_end_, count, data_ + gap_begin_);
+            gap_begin_ += count;
+            gap_end_ += count;
+        }
+    }
+
+    // Элементы за разрывом переносятся в конец нового буфера
+    void Reallocate(size_t new_capacity) {
+        Buffer data(new_capacity, data_.GetAllocator());
+        const size_t after = Capacity() - gap_end_;
+        detail::UninitializedRelocate(data_.GetAddress(), gap_begin_, data.GetAddress());
+        detail::UninitializedRelocate(data_ + gap_end_, after, data + (new_capacity - after));
+        data_.Swap(data);
+        gap_end_ = new_capacity - after;
+    }
+
+    Buffer data_;
+    size_t gap_begin_ = 0;
+    size_t gap_end_ = 0;
+};
+
+// Итератор хранит индекс и пересчитывает адрес с учётом разрыва при каждом обращении
+template <typename T, typename Alloc, typename Growth>
+template <bool Const>
+class GapVector<T, Alloc, Growth>::Iterator {
+    using Owner = std::conditional_t<Const, const GapVector, GapVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    Iterator() = default;
+
+    Iterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    // Неконстантный итератор преобразуется в константный
+    operator Iterator<true>() const noexcept requires(!Const) {
+        return Iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator old = *this;
+        --*this;
+        return old;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        return *this += -n;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
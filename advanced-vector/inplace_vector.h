@@ -0,0 +1,278 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Вектор вместимостью до N элементов, хранящий их внутри самого объекта. Память никогда
+// не выделяется: EmplaceBack, Insert и Resize сверх N бросают std::bad_alloc, а TryEmplaceBack
+// возвращает nullptr. Сдвиги элементов при вставке и удалении общие с Vector.
+// Для тривиально копируемых T вектор сам тривиально копируем
+template <typename T, size_t N>
+class InplaceVector {
+    static_assert(N > 0);
+
+    static constexpr bool kTrivialCopy = std::is_trivially_copyable_v<T>;
+    static constexpr bool kTrivialDestroy = std::is_trivially_destructible_v<T>;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    InplaceVector() = default;
+
+    explicit InplaceVector(size_t size) {
+        Resize(size);
+    }
+
+    InplaceVector(const InplaceVector& other) requires kTrivialCopy = default;
+
+    InplaceVector(const InplaceVector& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : size_(other.size_) {
+        std::uninitialized_copy_n(other.Data(), size_, Data());
+    }
+
+    InplaceVector(InplaceVector&& other) requires kTrivialCopy = default;
+
+    // Элементы other остаются в состоянии после перемещения
+    InplaceVector(InplaceVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : size_(other.size_) {
+        std::uninitialized_move_n(other.Data(), size_, Data());
+    }
+
+    InplaceVector& operator=(const InplaceVector& rhs) requires kTrivialCopy = default;
+
+    InplaceVector& operator=(const InplaceVector& rhs) {
+        if (this != &rhs) {
+            AssignCounted(rhs.begin(), rhs.size_);
+        }
+        return *this;
+    }
+
+    InplaceVector& operator=(InplaceVector&& rhs) requires kTrivialCopy = default;
+
+    InplaceVector& operator=(InplaceVector&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                           && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            AssignCounted(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+        return *this;
+    }
+
+    ~InplaceVector() requires kTrivialDestroy = default;
+
+    ~InplaceVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage_));
+    }
+
+    const T* Data() const noexcept {
+        return const_cast<InplaceVector&>(*this).Data();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ == N;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<InplaceVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Создаёт элемент в конце или возвращает nullptr, если места нет
+    template <typename... Types>
+    T* TryEmplaceBack(Types&&... values) {
+        if (IsFull()) {
+            return nullptr;
+        }
+        T* elem = std::construct_at(end(), std::forward<Types>(values)...);
+        ++size_;
+        return elem;
+    }
+
+    T* TryPushBack(const T& value) {
+        return TryEmplaceBack(value);
+    }
+
+    T* TryPushBack(T&& value) {
+        return TryEmplaceBack(std::move(value));
+    }
+
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        Grow(1);
+        return *TryEmplaceBack(std::forward<Types>(values)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(end());
+    }
+
+    template <typename... Types>
+    iterator Emplace(const_iterator cpos, Types&&... values) {
+        T* pos = begin() + (cpos - cbegin());
+        Grow(1);
+        detail::EmplaceInPlace(Data(), size_, pos, std::forward<Types>(values)...);
+        return pos;
+    }
+
+    iterator Insert(const_iterator cpos, const T& value) {
+        return Emplace(cpos, value);
+    }
+
+    iterator Insert(const_iterator cpos, T&& value) {
+        return Emplace(cpos, std::move(value));
+    }
+
+    // Вставляет элементы [first, last) перед cpos. Диапазон не должен ссылаться на элементы вектора
+    template <std::forward_iterator ForwardIt>
+    iterator InsertRange(const_iterator cpos, ForwardIt first, ForwardIt last) {
+        const size_t index = cpos - cbegin();
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        Grow(count);
+        if (count != 0) {
+            detail::InsertInPlace(Data(), size_, index, first, count);
+        }
+        return begin() + index;
+    }
+
+    iterator Erase(const_iterator cpos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        return EraseRange(cpos, cpos + 1);
+    }
+
+    iterator EraseRange(const_iterator cfirst, const_iterator clast) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* first = begin() + (cfirst - cbegin());
+        T* last = begin() + (clast - cbegin());
+        assert(first <= last && last <= end());
+        if (first != last) {
+            detail::EraseInPlace(Data(), size_, first, last);
+        }
+        return first;
+    }
+
+    // Новые элементы инициализируются значением
+    void Resize(size_t new_size) {
+        if (new_size > size_) {
+            Grow(new_size - size_);
+            detail::UninitializedValueConstructN(end(), new_size - size_);
+        } else {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+    }
+
+    // Заменяет содержимое элементами [first, last)
+    template <std::forward_iterator ForwardIt>
+    void Assign(ForwardIt first, ForwardIt last) {
+        AssignCounted(first, static_cast<size_t>(std::distance(first, last)));
+    }
+
+    void Swap(InplaceVector& other) noexcept(std::is_nothrow_swappable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+        InplaceVector& shorter = size_ < other.size_ ? *this : other;
+        InplaceVector& longer = size_ < other.size_ ? other : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        std::uninitialized_move(longer.begin() + shorter.size_, longer.end(), shorter.end());
+        std::destroy(longer.begin() + shorter.size_, longer.end());
+        std::swap(size_, other.size_);
+    }
+
+    bool operator==(const InplaceVector& other) const {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    // Вместимость не растёт: вставка сверх N — ошибка, как исчерпание памяти у Vector
+    void Grow(size_t count) const {
+        if (count > N - size_) {
+            throw std::bad_alloc();
+        }
+    }
+
+    template <typename It>
+    void AssignCounted(It first, size_t count) {
+        if (count > N) {
+            throw std::bad_alloc();
+        }
+        if (count <= size_) {
+            std::copy_n(first, count, Data());
+            std::destroy_n(Data() + count, size_ - count);
+        } else {
+            It mid = std::next(first, size_);
+            std::copy(first, mid, Data());
+            std::uninitialized_copy_n(mid, count - size_, end());
+        }
+        size_ = count;
+    }
+
+    alignas(T) std::byte storage_[sizeof(T) * N];
+    size_t size_ = 0;
+};
+
+// Синоним для кода, привыкшего к имени boost::container::static_vector
+template <typename T, size_t N>
+using StaticVector = InplaceVector<T, N>;
+
+template <typename T, size_t N>
+struct is_trivially_relocatable<InplaceVector<T, N>> : is_trivially_relocatable<T> {
+};
@@ -1,11 +1,46 @@
+// Тесты проверяют утверждения и в сборках с -DNDEBUG
+#undef NDEBUG
+
 #include "vector.h"
+#include "allocators.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "gap_vector.h"
+#include "inplace_vector.h"
+#include "mapped_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "vector_execution.h"
+#include "vector_io.h"
+#include "vector_serialization.h"
+#include "vector_view.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <source_location>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <iostream>
 
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 namespace {
 
 // "Магическое" число, используемое для отслеживания живости объекта
@@ -117,8 +152,296 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Ресурс памяти, подсчитывающий выделения и освобождения
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {
+    }
+
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return upstream_->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+};
+
+// Аллокатор с идентификатором, распространяющийся при копировании, перемещении и обмене
+template <typename T>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    TaggedAllocator() = default;
+
+    explicit TaggedAllocator(int tag)
+        : tag(tag) {
+    }
+
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U>& other) noexcept
+        : tag(other.tag) {
+    }
+
+    T* allocate(size_t n) {
+        ++num_allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ++num_deallocations;
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const TaggedAllocator& other) const noexcept {
+        return tag == other.tag;
+    }
+
+    int tag = 0;
+
+    static inline int num_allocations = 0;
+    static inline int num_deallocations = 0;
+};
+
+// Аллокатор, подсчитывающий число выделений и пиковый объём одновременно занятой памяти
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        ++num_allocations;
+        live_bytes += n * sizeof(T);
+        peak_bytes = std::max(peak_bytes, live_bytes);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        live_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    static void Reset() {
+        num_allocations = 0;
+        live_bytes = 0;
+        peak_bytes = 0;
+    }
+
+    static inline size_t num_allocations = 0;
+    static inline size_t live_bytes = 0;
+    static inline size_t peak_bytes = 0;
+};
+
+// Тип для проверки параллельных операций: счётчики атомарны, исключение бросает
+// копирование или создание с заданным порядковым номером
+struct ParallelObj {
+    ParallelObj() {
+        Construct();
+    }
+
+    ParallelObj(const ParallelObj& other)
+        : value(other.value) {
+        Construct();
+    }
+
+    ParallelObj& operator=(const ParallelObj& other) = default;
+
+    ~ParallelObj() {
+        --alive;
+    }
+
+    static void Construct() {
+        if (throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+
+    int value = 0;
+
+    static inline std::atomic<int> alive = 0;
+    static inline std::atomic<long> throw_countdown = 0;
+};
+
+// Только перемещаемый элемент, перемещение которого может бросить; счётчики общие с ParallelObj
+struct ParallelMoveOnly {
+    ParallelMoveOnly() {
+        ParallelObj::Construct();
+    }
+
+    ParallelMoveOnly(ParallelMoveOnly&& other)
+        : value(other.value) {
+        ParallelObj::Construct();
+    }
+
+    ~ParallelMoveOnly() {
+        --ParallelObj::alive;
+    }
+
+    int value = 0;
+};
+
+// Сверяет SIMD-ядра всех поддерживаемых процессором наборов инструкций с алгоритмами std
+// на массивах всех длин до нескольких ширин регистра и на невыровненных началах
+template <typename T>
+void CheckSimdKernels() {
+    using namespace detail::simd;
+    using Find = FindKernel<T, alignof(T)>;
+    using Count = CountKernel<T, alignof(T)>;
+    using Fill = FillKernel<T, alignof(T)>;
+    using Equal = EqualKernel<T, alignof(T)>;
+    using MinMax = MinMaxKernel<T, alignof(T)>;
+    using Sum = SumKernel<T, alignof(T)>;
+    std::vector<T> data(300);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<T>((i * 37) % 101);
+    }
+    for (int isa = 0; isa <= static_cast<int>(DetectIsa()); ++isa) {
+        const Isa current = static_cast<Isa>(isa);
+        for (size_t first = 0; first < 3; ++first) {
+            for (size_t n = 0; first + n <= data.size(); ++n) {
+                const T* begin = data.data() + first;
+                const T* end = begin + n;
+                const T value = static_cast<T>(n % 101);
+                const size_t found = Run<Find>(current, begin, n, value);
+                assert(found == static_cast<size_t>(std::find(begin, end, value) - begin));
+                const size_t count = Run<Count>(current, begin, n, value);
+                assert(count == static_cast<size_t>(std::count(begin, end, value)));
+                const T sum = Run<Sum>(current, begin, n);
+                assert(sum == std::accumulate(begin, end, T{}));
+                assert(Run<Equal>(current, begin, begin, n));
+                if (n > 0) {
+                    const auto [min, max] = Run<MinMax>(current, begin, n);
+                    assert(min == *std::min_element(begin, end) && max == *std::max_element(begin, end));
+                    std::vector<T> other(begin, end);
+                    other[n / 2] = static_cast<T>(other[n / 2] + 1);
+                    assert(!Run<Equal>(current, begin, other.data(), n));
+                    const T last = other.back();
+                    Run<Fill>(current, other.data(), n - 1, value);
+                    assert(std::count(other.begin(), other.end() - 1, value) == static_cast<long>(n - 1));
+                    assert(other.back() == last);
+                }
+            }
+        }
+    }
+}
+
+// Выполняет f в дочернем процессе. Возвращает true, если процесс аварийно завершился сигналом
+template <typename F>
+bool Crashes(F f) {
+    std::cout.flush();
+    const pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        // Сообщения об ошибках из дочернего процесса не нужны в выводе тестов
+        [[maybe_unused]] FILE* null = std::freopen("/dev/null", "w", stderr);
+        f();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status);
+}
+
+template <typename T, typename Checking>
+using CheckedVector = Vector<T, std::allocator<T>, DoublingGrowth, RawMemory<T>, NoStats, Checking>;
+
+// Источник, отдающий не больше kMaxRead байт за вызов, как сетевое соединение
+class SlowSource {
+public:
+    static constexpr size_t kMaxRead = 7;
+
+    explicit SlowSource(std::string data)
+        : data_(std::move(data)) {
+    }
+
+    size_t Read(void* dest, size_t bytes) {
+        const size_t count = std::min({bytes, kMaxRead, data_.size() - pos_});
+        std::memcpy(dest, data_.data() + pos_, count);
+        pos_ += count;
+        return count;
+    }
+
+private:
+    std::string data_;
+    size_t pos_ = 0;
+};
+
+// Приёмник, считающий вызовы Write
+struct CountingSink {
+    void Write(const void* data, size_t bytes) {
+        ++writes;
+        out.append(static_cast<const char*>(data), bytes);
+    }
+
+    size_t writes = 0;
+    std::string out;
+};
+
+// Потребители, принимающие элементы без владения
+int SumOf(std::span<const int> values) {
+    return std::accumulate(values.begin(), values.end(), 0);
+}
+
+size_t CountZeros(VectorView<int> view) {
+    return view.Count(0);
+}
+
 }  // namespace
 
+// Тип с нетривиальным деструктором, явно объявленный тривиально перемещаемым
+struct Relocatable {
+    explicit Relocatable(int value)
+        : value(std::make_unique<int>(value)) {
+    }
+
+    Relocatable(Relocatable&& other) noexcept
+        : value(std::move(other.value)) {
+        ++num_moved;
+    }
+
+    Relocatable& operator=(Relocatable&& other) = default;
+
+    ~Relocatable() {
+        ++num_destroyed;
+    }
+
+    std::unique_ptr<int> value;
+
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+template <>
+struct is_trivially_relocatable<Relocatable> : std::true_type {
+};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -559,84 +882,2084 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 100;
+    {
+        CountingResource resource;
+        pmr::Vector<int> v{&resource};
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.Size() == SIZE);
+        assert(v.GetAllocator().resource() == &resource);
+        assert(resource.allocations > 0);
+
+        // Копия получает ресурс по умолчанию, как и std::pmr::vector
+        pmr::Vector<int> copy(v);
+        assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+        assert(copy[SIZE - 1] == static_cast<int>(SIZE - 1));
+
+        // Присваивание не меняет ресурс приёмника
+        CountingResource other_resource;
+        pmr::Vector<int> target{&other_resource};
+        target = v;
+        assert(target.GetAllocator().resource() == &other_resource);
+        assert(target.Size() == SIZE);
+        assert(target[SIZE / 2] == static_cast<int>(SIZE / 2));
+
+        // При различных ресурсах перемещение выполняется поэлементно
+        const size_t allocations_before = other_resource.allocations;
+        pmr::Vector<int> moved_into{&other_resource};
+        moved_into = std::move(v);
+        assert(moved_into.GetAllocator().resource() == &other_resource);
+        assert(other_resource.allocations == allocations_before + 1);
+        assert(moved_into.Size() == SIZE);
+        assert(moved_into[SIZE - 1] == static_cast<int>(SIZE - 1));
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        std::byte buffer[4096];
+        std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer), std::pmr::null_memory_resource()};
+        pmr::Vector<Obj> v{&arena};
+        Obj::ResetCounters();
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.Insert(v.cbegin(), Obj{0});
+        assert(v.Size() == 3);
+        assert(v[0].id == 0 && v[1].id == 1 && v[2].id == 2);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        using Alloc = TaggedAllocator<Obj>;
+        Obj::ResetCounters();
+        Alloc::num_allocations = 0;
+        Alloc::num_deallocations = 0;
+        {
+            Vector<Obj, Alloc> v(SIZE, Alloc{1});
+            Vector<Obj, Alloc> other(SIZE * 2, Alloc{2});
+
+            // Вместимости хватает, но аллокатор распространяется, поэтому буфер заменяется
+            other = v;
+            assert(other.GetAllocator().tag == 1);
+            assert(other.Size() == SIZE);
+            assert(other.Capacity() == SIZE);
+
+            Vector<Obj, Alloc> moved(Alloc{3});
+            moved = std::move(other);
+            assert(moved.GetAllocator().tag == 1);
+            assert(moved.Size() == SIZE);
+
+            Vector<Obj, Alloc> swapped(1, Alloc{4});
+            swapped.Swap(moved);
+            assert(swapped.GetAllocator().tag == 1);
+            assert(moved.GetAllocator().tag == 4);
+            assert(Obj::GetAliveObjectCount() == SIZE + SIZE + 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(Alloc::num_allocations == Alloc::num_deallocations);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+}
+
+void Test8() {
+    const size_t SIZE = 1000;
+    {
+        struct Point {
+            int x;
+            int y;
+        };
+        static_assert(is_trivially_relocatable_v<Point>);
+        Vector<Point> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack({static_cast<int>(i), -static_cast<int>(i)});
+        }
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == SIZE * 4);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i].x == static_cast<int>(i) && v[i].y == -static_cast<int>(i));
         }
-        return *this;
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+    {
+        Relocatable::num_moved = 0;
+        Relocatable::num_destroyed = 0;
+        {
+            Vector<Relocatable> v;
+            v.Reserve(SIZE / 8);
+            for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+                v.EmplaceBack(i);
+            }
+            // Вставка в заполненный вектор идёт через реаллокацию
+            assert(v.Size() == v.Capacity());
+            v.Emplace(v.begin() + v.Size() / 2, -1);
+            v.Reserve(SIZE * 2);
+            // При реаллокации элементы не перемещались и не уничтожались
+            assert(Relocatable::num_moved == 0);
+            assert(Relocatable::num_destroyed == 0);
+            assert(v.Size() == SIZE + 1);
+            assert(*v[SIZE / 2].value == -1);
+        }
+        assert(Relocatable::num_destroyed == static_cast<int>(SIZE + 1));
     }
-    ~C() {
-        ++dtor;
+    {
+        static_assert(is_trivially_relocatable_v<std::unique_ptr<int>>);
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(std::make_unique<int>(i));
+        }
+        v.Insert(v.cbegin(), std::make_unique<int>(-1));
+        assert(*v[0] == -1);
+        assert(*v[SIZE] == static_cast<int>(SIZE - 1));
+    }
+    {
+        static_assert(is_trivially_relocatable_v<Vector<std::string>>);
+        Vector<Vector<std::string>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(1).EmplaceBack(std::to_string(i));
+        }
+        assert(v[SIZE - 1][1] == std::to_string(SIZE - 1));
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
-    }
-
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test9() {
+    const size_t SIZE = 100'000;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Insert(v.cbegin() + 1, -1);
+        v.Reserve(SIZE * 4);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 4);
+        assert(v[0] == 0 && v[1] == -1 && v[SIZE] == static_cast<int>(SIZE - 1));
+    }
+    {
+        // Порог в одну страницу: вектор переходит из malloc в mmap и растёт через mremap
+        using Alloc = MmapAllocator<uint64_t>;
+        Vector<uint64_t, Alloc> v(Alloc{4096});
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+            // Аргумент ссылается на элемент, буфер которого перераспределяется
+            if (v.Size() == v.Capacity()) {
+                v.PushBack(v[0]);
+                v.PopBack();
+            }
+        }
+        v.Reserve(SIZE * 8);
+        assert(v.Capacity() == SIZE * 8);
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == i);
+        }
+        Vector<uint64_t, Alloc> copy(v);
+        assert(copy.GetAllocator() == v.GetAllocator());
+        assert(copy[SIZE - 1] == SIZE - 1);
+    }
+    {
+        // Нетривиально перемещаемые элементы переносятся обычным образом
+        Vector<std::string, MallocAllocator<std::string>> v;
+        for (size_t i = 0; i < SIZE / 100; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        v.EmplaceBack(v[0]);
+        assert(v[SIZE / 100] == "0");
+        assert(v[SIZE / 100 - 1] == std::to_string(SIZE / 100 - 1));
+    }
+}
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+void Test10() {
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity()) {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+        assert(v[9] == 9);
+    }
+    {
+        Vector<int, std::allocator<int>, CacheLineGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 64 / sizeof(int));
+        v.Insert(v.cbegin(), 0);
+        assert(v.Capacity() == 64 / sizeof(int));
+        assert(v[0] == 0 && v[1] == 1);
+    }
+    {
+        Vector<char, std::allocator<char>, SizeClassGrowth<>> v;
+        v.PushBack('a');
+        assert(v.Capacity() == alignof(std::max_align_t));
+        v.Resize(5000);
+        assert(v.Capacity() == 8192);
+    }
+    {
+        // Resize растёт по политике, а не до точного размера
+        Vector<int> v(10);
+        v.Resize(11);
+        assert(v.Size() == 11);
+        assert(v.Capacity() == 20);
+        v.Resize(100);
+        assert(v.Capacity() == 100);
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test11() {
+    const size_t N = 8;
+    const int ID = 42;
+    using namespace std::literals;
+    using Alloc = CountingAllocator<Obj>;
+    using SmallObjVector = SmallVector<Obj, N, Alloc>;
+    {
+        Obj::ResetCounters();
+        Alloc::Reset();
+        SmallObjVector v(N / 2);
+        assert(v.Capacity() == N);
+        for (size_t i = v.Size(); i < N; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        // Пока элементы помещаются во встроенный буфер, память не выделяется
+        assert(Alloc::num_allocations == 0);
+        v.EmplaceBack(ID, "Ivan"s);
+        assert(Alloc::num_allocations == 1);
+        assert(v.Size() == N + 1);
+        assert(v.Capacity() == N * 2);
+        assert(v[N].id == ID && v[N].name == "Ivan"s);
+        assert(Obj::num_moved == static_cast<int>(N));
+        assert(Obj::num_copied == 0);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N + 1));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = N / 2;
+        try {
+            SmallObjVector v(N);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::num_default_constructed == static_cast<int>(N / 2 - 1));
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+    {
+        Obj::ResetCounters();
+        SmallObjVector v(N);
+        try {
+            v[N / 2].throw_on_copy = true;
+            SmallObjVector v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+            assert(Obj::num_copied == static_cast<int>(N / 2));
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N));
+    }
+    {
+        SmallVector<TestObj, 1> v(1);
+        assert(v.Size() == v.Capacity());
+        // Вставка ссылки на встроенный элемент при переходе в динамическую память
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+        v.EmplaceBack(std::move(v[1]));
+        assert(v[2].IsAlive());
+    }
+    {
+        Obj::ResetCounters();
+        SmallObjVector v(N / 2);
+        v.Reserve(N);
+        const int old_num_moved = Obj::num_moved;
+        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
+        assert(&*pos == &v[1]);
+        assert(v[1].id == ID);
+        assert(Obj::num_moved == old_num_moved + 1);
+        assert(Obj::num_move_assigned == static_cast<int>(N / 2 - 1));
+        v.Erase(v.cbegin());
+        assert(v[0].id == ID);
+        v.Resize(1);
+        assert(v.Size() == 1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        Obj::ResetCounters();
+        SmallObjVector inline_v(N);
+        inline_v[0].id = 1;
+        SmallObjVector moved(std::move(inline_v));
+        assert(moved.Size() == N && moved[0].id == 1);
+        assert(inline_v.Size() == 0);
+        assert(Obj::num_moved == static_cast<int>(N));
+
+        SmallObjVector heap_v(N * 2);
+        heap_v[0].id = 2;
+        const int old_num_moved = Obj::num_moved;
+        SmallObjVector stolen(std::move(heap_v));
+        assert(Obj::num_moved == old_num_moved);
+        assert(stolen.Size() == N * 2 && stolen[0].id == 2);
+        assert(heap_v.Capacity() == N);
+
+        stolen.Swap(moved);
+        assert(stolen.Size() == N && stolen[0].id == 1);
+        assert(moved.Size() == N * 2 && moved[0].id == 2);
+
+        moved = stolen;
+        assert(moved.Size() == N && moved[0].id == 1);
+        stolen = std::move(moved);
+        assert(stolen.Size() == N && stolen[0].id == 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    assert(CountingAllocator<Obj>::live_bytes == 0);
+}
+
+void Test12() {
+    const size_t SIZE = 10;
+    {
+        Vector<int> v;
+        const std::vector<int> src{1, 2, 3, 4};
+        v.Append(src.begin(), src.end());
+        assert(v.Size() == 4 && v.Capacity() == 4);
+
+        // Входные итераторы: элементы добавляются по одному и поворачиваются на место
+        std::istringstream input("7 8 9");
+        v.InsertRange(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 7, 8, 9, 2, 3, 4}));
+
+        auto pos = v.EraseRange(v.cbegin() + 1, v.cbegin() + 4);
+        assert(pos == v.begin() + 1);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 2, 3, 4}));
+        assert(v.EraseRange(v.cend(), v.cend()) == v.end());
+
+        v.Reserve(SIZE);
+        v.InsertRange(v.cbegin() + 1, src.begin(), src.begin() + 2);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 1, 2, 2, 3, 4}));
+
+        const std::list<int> other{5, 6};
+        v.Assign(other.begin(), other.end());
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{5, 6}));
+    }
+    {
+        // Вставка в заполненный вектор: одна реаллокация, каждый старый элемент перемещён один раз
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> src(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+            src[i].id = static_cast<int>(SIZE + i);
+        }
+        Obj::ResetCounters();
+        auto pos = v.InsertRange(v.cbegin() + 2, src.begin(), src.end());
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE * 2);
+        assert(v.Capacity() == SIZE * 2);
+        assert(Obj::num_copied == static_cast<int>(SIZE));
+        assert(Obj::num_moved == static_cast<int>(SIZE));
+        assert(Obj::num_move_assigned == 0);
+        assert(v[1].id == 1 && v[2].id == static_cast<int>(SIZE) && v[SIZE + 2].id == 2);
+    }
+    {
+        // Вставка без реаллокации: короткий и длинный хвост
+        for (size_t index : {size_t{1}, SIZE - 1}) {
+            Obj::ResetCounters();
+            Vector<Obj> v(SIZE);
+            for (size_t i = 0; i < SIZE; ++i) {
+                v[i].id = static_cast<int>(i);
+            }
+            v.Reserve(SIZE * 2);
+            const std::vector<Obj> src(3, Obj{-1});
+            v.InsertRange(v.cbegin() + index, src.begin(), src.end());
+            assert(v.Size() == SIZE + 3);
+            assert(v.Capacity() == SIZE * 2);
+            for (size_t i = 0; i < v.Size(); ++i) {
+                const int expected = i < index ? static_cast<int>(i)
+                                   : i < index + 3 ? -1 : static_cast<int>(i - 3);
+                assert(v[i].id == expected);
+            }
+        }
+    }
+    {
+        // При ошибке копирования во время реаллокации вектор не меняется
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> src(3);
+        src[1].throw_on_copy = true;
+        try {
+            v.InsertRange(v.cbegin(), src.begin(), src.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 3));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        const std::vector<Obj> src(SIZE / 2, Obj{1});
+        v.Assign(src.begin(), src.end());
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE);
+        assert(Obj::num_assigned == static_cast<int>(SIZE / 2));
+        const std::vector<Obj> big(SIZE * 2, Obj{2});
+        v.Assign(big.begin(), big.end());
+        assert(v.Size() == SIZE * 2 && v.Capacity() == SIZE * 2);
+        assert(v[SIZE * 2 - 1].id == 2);
+        v.Assign(src.begin(), src.end());
+        v.Assign(big.begin(), big.begin() + SIZE);
+        assert(v.Size() == SIZE && v[SIZE - 1].id == 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + SIZE / 2 + SIZE * 2));
+    }
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.EmplaceBack(std::make_unique<int>(i));
+        }
+        v.EraseRange(v.cbegin(), v.cbegin() + SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(*v[0] == static_cast<int>(SIZE / 2));
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(Obj::num_default_constructed == SIZE * 2);
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == SIZE / 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            Vector<Obj> v(SIZE, default_init);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<double> v(SIZE, default_init);
+        std::fill(v.begin(), v.end(), 1.5);
+        v.ResizeDefaultInit(SIZE * 10);
+        assert(v.Size() == SIZE * 10);
+        assert(v[SIZE - 1] == 1.5);
+        v.Resize(SIZE * 11);
+        assert(v[SIZE * 11 - 1] == 0.0);
+    }
+}
+
+void Test14() {
+    using StatsVector = Vector<int, std::allocator<int>, DoublingGrowth, RawMemory<int>, VectorStats>;
+    static_assert(sizeof(Vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+    {
+        StatsVector v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        VectorStatsSnapshot stats = v.GetStats();
+        assert(stats.allocations == 4 && stats.allocated_bytes == (1 + 2 + 4 + 8) * sizeof(int));
+        assert(stats.relocated_bytes == (1 + 2 + 4) * sizeof(int));
+        assert(stats.memcpy_relocations == 3 && stats.move_relocations == 0 && stats.copy_relocations == 0);
+        assert(stats.peak_capacity_bytes == 8 * sizeof(int));
+        assert(stats.capacity_bytes == 8 * sizeof(int) && stats.wasted_bytes == 3 * sizeof(int));
+
+        v.Reserve(100);
+        stats = v.GetStats();
+        assert(stats.allocations == 5 && stats.relocated_bytes == (1 + 2 + 4 + 5) * sizeof(int));
+        assert(stats.peak_capacity_bytes == 100 * sizeof(int));
+
+        // Счётчики принадлежат экземпляру и не копируются
+        StatsVector copy(v);
+        assert(copy.GetStats().allocations == 1 && copy.GetStats().relocated_bytes == 0);
+        assert(Vector<int>(10).GetStats().allocations == 0);
+    }
+    {
+        Vector<std::string, std::allocator<std::string>, DoublingGrowth, RawMemory<std::string>, VectorStats> v;
+        v.Resize(3);
+        v.Reserve(10);
+        assert(v.GetStats().move_relocations == 1 && v.GetStats().relocated_bytes == 3 * sizeof(std::string));
+    }
+    {
+        struct ThrowingMove {
+            ThrowingMove() = default;
+            ThrowingMove(const ThrowingMove&) {
+            }
+            ThrowingMove(ThrowingMove&&) {
+            }
+            ThrowingMove& operator=(const ThrowingMove&) = default;
+            ThrowingMove& operator=(ThrowingMove&&) = default;
+        };
+        Vector<ThrowingMove, std::allocator<ThrowingMove>, DoublingGrowth, RawMemory<ThrowingMove>, VectorStats> v;
+        v.EmplaceBack();
+        v.EmplaceBack();
+        assert(v.GetStats().copy_relocations == 1 && v.GetStats().move_relocations == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>, DoublingGrowth, RawMemory<int, MallocAllocator<int>>, VectorStats> v;
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        VectorStatsSnapshot stats = v.GetStats();
+        assert(stats.allocations == 1 && stats.reallocations == 2 && stats.relocated_bytes == 0);
+    }
+    {
+        using SiteVector = Vector<int, std::allocator<int>, DoublingGrowth, RawMemory<int>, CallSiteStats>;
+        auto make = [] {
+            return SiteVector(CallSiteStats::Here());
+        };
+        SiteVector a = make();
+        SiteVector b = make();
+        a.PushBack(1);
+        b.PushBack(1);
+        b.PushBack(2);
+        b.PushBack(3);
+        VectorStatsSnapshot stats = a.GetStats();
+        assert(stats.allocations == 4 && stats.memcpy_relocations == 2);
+        assert(stats.capacity_bytes == (1 + 4) * sizeof(int) && stats.wasted_bytes == sizeof(int));
+        {
+            SiteVector c = make();
+            c.Reserve(10);
+            assert(c.GetStats().peak_capacity_bytes == 10 * sizeof(int));
+        }
+        stats = b.GetStats();
+        assert(stats.allocations == 5 && stats.capacity_bytes == (1 + 4) * sizeof(int));
+
+        bool found = false;
+        for (const CallSiteSnapshot& site : CallSiteStats::Collect()) {
+            if (std::string_view(site.location.file_name()) == std::source_location::current().file_name()) {
+                found = true;
+                assert(site.stats.allocations == stats.allocations);
+            }
+        }
+        assert(found);
+
+        SiteVector detached;
+        detached.PushBack(1);
+        assert(detached.GetStats().allocations == 0);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        v.Resize(SIZE / 2);
+        assert(v.Capacity() == SIZE * 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE / 2);
+        assert(Obj::num_moved == SIZE / 2 + SIZE && Obj::GetAliveObjectCount() == SIZE / 2);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0 && v.begin() == nullptr);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Relocatable> v;
+        v.Reserve(SIZE);
+        for (size_t i = 0; i < SIZE / 4; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        Relocatable::num_moved = 0;
+        Relocatable::num_destroyed = 0;
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE / 4 && *v[SIZE / 4 - 1].value == SIZE / 4 - 1);
+        assert(Relocatable::num_moved == 0 && Relocatable::num_destroyed == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v.Resize(1);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 1 && v[0] == 0);
+    }
+    {
+        SmallVector<std::string, 4> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        v.Resize(3);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 4 && v[2] == "2");
+        v.ShrinkToFit();
+        assert(v.Capacity() == 4 && v.Size() == 3);
+    }
+    {
+        using ShrinkingVector = Vector<int, std::allocator<int>, AutoShrinkGrowth<>, RawMemory<int>, VectorStats>;
+        ShrinkingVector v;
+        v.Resize(1024);
+        assert(v.Capacity() == 1024);
+        v.Resize(256);
+        assert(v.Capacity() == 1024);
+        v.PopBack();
+        assert(v.Capacity() == 512 && v.Size() == 255);
+        // Между порогами вставки и удаления не перевыделяют память
+        const size_t allocations = v.GetStats().allocations;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+            v.PushBack(i);
+            v.PopBack();
+            v.PopBack();
+        }
+        assert(v.Capacity() == 512 && v.GetStats().allocations == allocations);
+
+        std::iota(v.begin(), v.end(), 0);
+        auto it = v.EraseRange(v.begin() + 10, v.begin() + 250);
+        assert(v.Size() == 15 && v.Capacity() == 32);
+        assert(it == v.begin() + 10 && *it == 250);
+        v.Clear();
+        assert(v.Capacity() == 16);
+    }
+}
+
+void Test16() {
+    const size_t SIZE = 10000;
+    const int THREADS = 8;
+    {
+        ConcurrentVector<size_t> v;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, t, SIZE] {
+                for (size_t i = 0; i < SIZE; ++i) {
+                    v.EmplaceBack(t * SIZE + i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(v.Size() == THREADS * SIZE);
+        std::vector<bool> seen(THREADS * SIZE);
+        v.ForEach([&seen](size_t value) {
+            assert(!seen[value]);
+            seen[value] = true;
+        });
+        assert(std::find(seen.begin(), seen.end(), false) == seen.end());
+        assert(v.TryGet(THREADS * SIZE) == nullptr);
+    }
+    {
+        Obj::ResetCounters();
+        ConcurrentVector<Obj> v;
+        // Адреса элементов не меняются при росте
+        const Obj* first = &v.EmplaceBack(1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack();
+        }
+        assert(&v[0] == first && first->id == 1);
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE + 2 && v.TryGet(SIZE + 1) == nullptr);
+        v.EmplaceBack();
+        assert(v.TryGet(SIZE + 2) != nullptr);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test17() {
+    const size_t SIZE = detail::kMinParallelChunk * 4 + 3;
+    {
+        std::vector<std::atomic<int>> state(SIZE);
+        auto op = [&state](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                ++state[i];
+            }
+            if (first <= SIZE / 2 && SIZE / 2 < last) {
+                for (size_t i = first; i < last; ++i) {
+                    --state[i];
+                }
+                throw std::runtime_error("Oops");
+            }
+        };
+        auto undo = [&state](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                --state[i];
+            }
+        };
+        try {
+            detail::ForEachChunk(SIZE, 4, op, undo);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(std::all_of(state.begin(), state.end(), [](const std::atomic<int>& x) {
+            return x == 0;
+        }));
+    }
+    {
+        Vector<std::string> v(std::execution::par, SIZE);
+        assert(v.Size() == SIZE && v[SIZE - 1].empty());
+        std::vector<std::string> source(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            source[i] = std::to_string(i);
+        }
+        v.Assign(std::execution::par, source.begin(), source.begin() + SIZE / 2);
+        assert(v.Size() == SIZE / 2 && v[SIZE / 2 - 1] == std::to_string(SIZE / 2 - 1));
+        v.Assign(std::execution::par, source.begin(), source.end());
+        assert(v.Size() == SIZE && v[SIZE - 1] == std::to_string(SIZE - 1));
+        v.Reserve(std::execution::par, SIZE * 2);
+        assert(v.Capacity() == SIZE * 2 && v[SIZE / 3] == std::to_string(SIZE / 3));
+        v.Clear(std::execution::par);
+        assert(v.Size() == 0 && v.Capacity() == SIZE * 2);
+    }
+    {
+        ParallelObj::throw_countdown = SIZE / 2;
+        try {
+            Vector<ParallelObj> v(std::execution::par, SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(ParallelObj::alive == 0);
+
+        ParallelObj::throw_countdown = 0;
+        Vector<ParallelObj> v(std::execution::par_unseq, SIZE / 2);
+        v[0].value = 42;
+        std::vector<ParallelObj> source(SIZE);
+        ParallelObj::throw_countdown = SIZE / 3;
+        try {
+            v.Assign(std::execution::par, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE / 2 && v[0].value == 42);
+        assert(ParallelObj::alive == static_cast<int>(SIZE / 2 + SIZE));
+
+        ParallelObj::throw_countdown = SIZE / 4;
+        try {
+            v.Reserve(std::execution::par, SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == SIZE / 2 && v[0].value == 42);
+        assert(ParallelObj::alive == static_cast<int>(SIZE / 2 + SIZE));
+    }
+    assert(ParallelObj::alive == 0);
+    {
+        // Бросающее перемещение без копирования: уже перенесённые части не теряются
+        ParallelObj::throw_countdown = 0;
+        Vector<ParallelMoveOnly> v(SIZE);
+        v[SIZE - 1].value = 42;
+        ParallelObj::throw_countdown = SIZE / 2;
+        try {
+            v.Reserve(std::execution::par, SIZE * 2);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE && v[SIZE - 1].value == 42);
+        assert(ParallelObj::alive == static_cast<int>(SIZE));
+        ParallelObj::throw_countdown = 0;
+        v.Reserve(std::execution::par, SIZE * 2);
+        assert(v.Capacity() == SIZE * 2 && v[SIZE - 1].value == 42);
+        assert(ParallelObj::alive == static_cast<int>(SIZE));
+    }
+    assert(ParallelObj::alive == 0);
+}
+
+void Test18() {
+    CheckSimdKernels<int8_t>();
+    CheckSimdKernels<uint16_t>();
+    CheckSimdKernels<int32_t>();
+    CheckSimdKernels<uint64_t>();
+    CheckSimdKernels<float>();
+    CheckSimdKernels<double>();
+    {
+        // Счётчики узких дорожек сбрасываются до переполнения
+        std::vector<int8_t> data(100000, 7);
+        assert(detail::simd::Count<1>(data.data(), data.size(), int8_t{7}) == data.size());
+        // Целые суммируются по модулю 2^N
+        std::vector<int32_t> big(1000, std::numeric_limits<int32_t>::max());
+        assert(detail::simd::Sum<4>(big.data(), big.size()) == std::accumulate(big.begin(), big.end(), 0,
+            [](int32_t lhs, int32_t rhs) {
+                return static_cast<int32_t>(static_cast<uint32_t>(lhs) + static_cast<uint32_t>(rhs));
+            }));
+    }
+    {
+        Vector<float, AlignedAllocator<float, 64>> v(1000);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+        v.Fill(1.5f);
+        assert(v.Count(1.5f) == 1000 && v.Sum() == 1500.0f);
+        v[700] = -2.0f;
+        v[10] = 8.0f;
+        assert(v.Find(-2.0f) == v.begin() + 700 && v.Find(3.0f) == v.end());
+        assert(v.MinMax() == std::make_pair(-2.0f, 8.0f));
+        v.Reserve(5000);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % 64 == 0);
+
+        Vector<float, AlignedAllocator<float, 64>> other(v);
+        assert(other == v);
+        other[999] = 0.0f;
+        assert(!(other == v));
+        other.PopBack();
+        assert(!(other == v));
+    }
+    {
+        SmallVector<int, 8> v;
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(i % 5);
+        }
+        const auto& cv = v;
+        assert(cv.Find(3) == cv.begin() + 3 && cv.Count(4) == 4 && cv.Sum() == 40);
+        assert(cv.MinMax() == std::make_pair(0, 4));
+    }
+    {
+        Vector<std::string> v(3);
+        v.Fill("abc");
+        v[1] = std::string("z");
+        assert(v.Count("abc") == 2 && v.Find("z") == v.begin() + 1);
+        assert(v.MinMax() == std::make_pair(std::string("abc"), std::string("z")));
+        assert(v.Sum() == "abczabc");
+        Vector<std::string> other(v);
+        assert(other == v);
+    }
+}
+
+void Test19() {
+    struct alignas(64) Padded {
+        int value = 0;
+    };
+    auto is_aligned = [](const void* ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    };
+    {
+        // std::allocator выделяет память под сверхвыровненные типы выровненным operator new
+        Vector<Padded> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(Padded{i});
+            assert(is_aligned(v.begin(), 64));
+        }
+        SmallVector<Padded, 4> small(2);
+        assert(is_aligned(small.begin(), 64));
+        small.Resize(10);
+        assert(is_aligned(small.begin(), 64) && small[9].value == 0);
+    }
+    {
+        static_assert(AlignedAllocator<Padded, 16>::alignment == 64);
+        Vector<Padded, AlignedAllocator<Padded, 4096>> v(3);
+        assert(is_aligned(v.begin(), 4096));
+    }
+    {
+        using Alloc = HugePageAllocator<uint64_t>;
+        constexpr size_t kHugePage = Alloc::kHugePageSize;
+        constexpr size_t kPerPage = kHugePage / sizeof(uint64_t);
+        Vector<uint64_t, Alloc> v;
+        v.PushBack(0);
+        assert(is_aligned(v.begin(), 64));
+        // Рост через порог и дальше по отображениям: адрес всегда кратен размеру huge page
+        for (uint64_t i = 1; i < 3 * kPerPage; ++i) {
+            v.PushBack(i);
+            if (v.Capacity() * sizeof(uint64_t) >= kHugePage) {
+                assert(is_aligned(v.begin(), kHugePage));
+            }
+        }
+        v.Reserve(16 * kPerPage);
+        assert(is_aligned(v.begin(), kHugePage));
+        for (uint64_t i = 0; i < 3 * kPerPage; ++i) {
+            assert(v[i] == i);
+        }
+        v.Resize(kPerPage + 1);
+        v.ShrinkToFit();
+        assert(v.Capacity() == kPerPage + 1 && is_aligned(v.begin(), kHugePage));
+        assert(v[kPerPage] == kPerPage);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 9);
+
+        Vector<uint64_t, Alloc> copy(Alloc{4096});
+        copy.Reserve(1000);
+        assert(is_aligned(copy.begin(), kHugePage));
+        assert(!(copy.GetAllocator() == v.GetAllocator()));
+    }
+}
+
+void Test20() {
+    struct Record {
+        uint64_t id;
+        double value;
+        char tag[8];
+    };
+    const auto path = std::filesystem::temp_directory_path()
+                      / ("mapped_vector_test_" + std::to_string(getpid()));
+    std::filesystem::remove(path);
+    const size_t SIZE = 100'000;
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0 && v.Capacity() > 0);
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(Record{i, static_cast<double>(i) / 2, "rec"});
+        }
+        // Аргумент ссылается на элемент, отображение которого переносится при росте
+        while (v.Size() != v.Capacity()) {
+            v.PushBack(v[0]);
+        }
+        v.PushBack(v[1]);
+        assert(v[v.Size() - 1].id == 1);
+        v.Resize(SIZE + 1);
+        assert(v[SIZE].id == 0 && v[SIZE].value == 0.0);
+        v[SIZE].id = 42;
+        v.Flush();
+
+        // Файл открыт этим вектором
+        try {
+            MappedVector<Record> other(path);
+            assert(false && "Exception is expected");
+        } catch (const std::system_error&) {
+        }
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == SIZE + 1 && v[SIZE].id == 42);
+        for (uint64_t i = 0; i < SIZE; ++i) {
+            assert(v[i].id == i && v[i].value == static_cast<double>(i) / 2 && std::string_view(v[i].tag) == "rec");
+        }
+        const size_t capacity = v.Capacity();
+        v.PopBack();
+        v.Reserve(capacity * 3);
+        assert(v.Capacity() >= capacity * 3 && v.Size() == SIZE);
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == SIZE && moved[SIZE - 1].id == SIZE - 1);
+        moved.Clear();
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0 && v.Capacity() > SIZE);
+    }
+    {
+        // Файл с элементами другого типа не открывается
+        try {
+            MappedVector<uint64_t> v(path);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+void Test21() {
+    {
+        Vector<uint32_t> v;
+        for (uint32_t i = 0; i < 100'000; ++i) {
+            v.PushBack(i * 3);
+        }
+        CountingSink sink;
+        Serialize(v, sink);
+        // Заголовок и все элементы одним блоком
+        assert(sink.writes == 2);
+        SlowSource source(sink.out);
+        const auto copy = Deserialize<Vector<uint32_t>>(source);
+        assert(copy == v && copy.Capacity() == v.Size());
+
+        SlowSource chunked(sink.out);
+        size_t total = 0;
+        size_t chunks = 0;
+        const size_t count = DeserializeChunked<uint32_t>(chunked, 4096, [&](std::span<uint32_t> chunk) {
+            assert(chunk.size() <= 4096);
+            for (const uint32_t value : chunk) {
+                assert(value == v[total]);
+                ++total;
+            }
+            ++chunks;
+        });
+        assert(count == v.Size() && total == count && chunks == (count + 4095) / 4096);
+
+        // Данные другого типа и оборванные данные не читаются
+        SlowSource other(sink.out);
+        try {
+            Deserialize<Vector<uint64_t>>(other);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        SlowSource truncated(sink.out.substr(0, sink.out.size() - 1));
+        try {
+            Deserialize<Vector<uint32_t>>(truncated);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        // Заголовок обещает 2^40 элементов, а данных почти нет: память под них заранее не выделяется
+        detail::SerializedHeader header;
+        header.elem_size = sizeof(uint32_t);
+        header.count = uint64_t{1} << 40;
+        std::string lying(reinterpret_cast<const char*>(&header), sizeof(header));
+        lying += "12345678";
+        SlowSource source(lying);
+        try {
+            Deserialize<Vector<uint32_t>>(source);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error& e) {
+            assert(std::string_view(e.what()).find("end of data") != std::string_view::npos);
+        }
+
+        // Так же для длины строки и для числа строк
+        CountingSink sink;
+        Serialize(Vector<std::string>(1), sink);
+        std::string strings = sink.out.substr(0, sizeof(header));
+        const uint64_t length = uint64_t{1} << 40;
+        strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        strings += "abc";
+        SlowSource string_source(strings);
+        Vector<std::string> partial(2);
+        partial[1] = "kept";
+        try {
+            detail::ReadVector(string_source, partial);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(partial.Size() == 2 && partial[1] == "kept");
+
+        detail::SerializedHeader many;
+        many.count = uint64_t{1} << 40;
+        std::string many_strings(reinterpret_cast<const char*>(&many), sizeof(many));
+        SlowSource many_source(many_strings);
+        try {
+            Deserialize<Vector<std::string>>(many_source);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        Vector<std::string> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(std::string(static_cast<size_t>(i % 50), static_cast<char>('a' + i % 26)));
+        }
+        std::stringstream stream;
+        OstreamSink sink(stream);
+        Serialize(v, sink);
+        Serialize(Vector<std::string>{}, sink);
+        IstreamSource source(stream);
+        assert(Deserialize<Vector<std::string>>(source) == v);
+        assert(Deserialize<Vector<std::string>>(source).Size() == 0);
+
+        std::stringstream again;
+        OstreamSink again_sink(again);
+        Serialize(v, again_sink);
+        IstreamSource again_source(again);
+        Vector<std::string> moved;
+        DeserializeChunked<std::string>(again_source, 64, [&moved](std::span<std::string> chunk) {
+            for (std::string& s : chunk) {
+                moved.PushBack(std::move(s));
+            }
+        });
+        assert(moved == v);
+    }
+    {
+        SmallVector<Vector<std::string>, 2> v;
+        v.EmplaceBack();
+        v.EmplaceBack(2);
+        v[1][1] = "nested";
+        v.EmplaceBack(1);
+        CountingSink sink;
+        Serialize(v, sink);
+        SlowSource source(sink.out);
+        const auto copy = Deserialize<SmallVector<Vector<std::string>, 2>>(source);
+        assert(copy.Size() == 3 && copy[0].Size() == 0 && copy[1][1] == "nested" && copy[2][0].empty());
+    }
+}
+
+void Test22() {
+    {
+        SoaVector<int, std::string, double> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i, std::to_string(i), i * 0.5);
+        }
+        assert(v.Size() == 100 && v.Capacity() == 128);
+        const auto [id, name, value] = v[42];
+        assert(id == 42 && name == "42" && value == 21.0);
+        const auto ids = v.Column<0>();
+        assert(std::accumulate(ids.begin(), ids.end(), 0) == 4950);
+
+        // Аргументы ссылаются на поля записи, столбцы которой переносятся при росте
+        while (v.Size() != v.Capacity()) {
+            v.EmplaceBack(0, "", 0.0);
+        }
+        v.EmplaceBack(std::get<0>(v[1]), std::get<1>(v[1]), std::get<2>(v[1]));
+        assert(v.Capacity() == 256 && std::get<1>(v[128]) == "1" && std::get<2>(v[128]) == 0.5);
+
+        v.Erase(0);
+        assert(v.Size() == 128 && std::get<0>(v[0]) == 1 && std::get<1>(v[0]) == "1");
+        v.Resize(10);
+        assert(v.Column<1>().back() == "10");
+        v.Resize(20);
+        assert(std::get<0>(v[19]) == 0 && std::get<1>(v[19]).empty());
+
+        SoaVector<int, std::string, double> copy(v);
+        assert(copy.Size() == 20 && std::get<1>(copy[9]) == "10");
+        SoaVector<int, std::string, double> moved(std::move(copy));
+        assert(copy.Size() == 0 && moved.Size() == 20);
+        copy = moved;
+        assert(copy.Size() == 20 && copy.Column<2>()[0] == 0.5);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == 256);
+    }
+    {
+        // Политика роста задаётся первым параметром BasicSoaVector
+        BasicSoaVector<OneAndHalfGrowth, int, double> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i, i * 0.5);
+        }
+        assert(v.Size() == 10 && v.Capacity() == 13);
+        v.Erase(3);
+        assert(v.Size() == 9 && v.Column<0>()[3] == 4 && v.Column<1>()[8] == 4.5);
+    }
+    {
+        ParallelObj::throw_countdown = 0;
+        {
+            SoaVector<int, ParallelObj, std::string> v;
+            for (int i = 0; i < 8; ++i) {
+                v.EmplaceBack(i, ParallelObj{}, std::to_string(i));
+            }
+            // Исключение при копировании в новый столбец: размер, вместимость и поля сохраняются
+            ParallelObj::throw_countdown = 5;
+            try {
+                v.EmplaceBack(8, ParallelObj{}, "8");
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 8 && v.Capacity() == 8 && ParallelObj::alive == 8);
+            assert(v.Column<0>()[7] == 7 && v.Column<2>()[7] == "7");
+
+            // Исключение при создании поля новой записи
+            v.PopBack();
+            ParallelObj::throw_countdown = 2;
+            try {
+                v.EmplaceBack(7, ParallelObj{}, "7");
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 7 && ParallelObj::alive == 7);
+
+            ParallelObj::throw_countdown = 5;
+            try {
+                v.Resize(20);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 7 && ParallelObj::alive == 7 && v.Column<2>()[6] == "6");
+
+            ParallelObj::throw_countdown = 0;
+            v.EmplaceBack(7, ParallelObj{}, "7");
+            v.EmplaceBack(8, ParallelObj{}, "8");
+            assert(v.Size() == 9 && v.Capacity() == 16 && v.Column<2>()[8] == "8");
+        }
+        assert(ParallelObj::alive == 0);
+    }
+}
+
+void Test23() {
+    {
+        Vector<std::string> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        auto it = v.EraseUnordered(v.begin() + 2);
+        assert(v.Size() == 9 && *it == "9" && v[8] == "8");
+        it = v.EraseUnordered(v.end() - 1);
+        assert(v.Size() == 8 && it == v.end() && v[2] == "9");
+
+        const size_t removed = v.EraseIf([](const std::string& s) {
+            return (s[0] - '0') % 2 == 1;
+        });
+        assert(removed == 5);
+        assert((std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"0", "4", "6"}));
+    }
+    {
+        // Каждый элемент проверяется один раз, переносится не больше элементов, чем удаляется
+        for (size_t size = 0; size < 40; ++size) {
+            for (unsigned mask_seed = 0; mask_seed < 8; ++mask_seed) {
+                Vector<Obj> v;
+                for (size_t i = 0; i < size; ++i) {
+                    v.EmplaceBack(static_cast<int>(i));
+                }
+                auto removed_pred = [mask_seed](const Obj& obj) {
+                    return ((obj.id * 7 + static_cast<int>(mask_seed)) % 3) == 0;
+                };
+                size_t expected_removed = 0;
+                std::vector<int> expected_kept;
+                for (size_t i = 0; i < size; ++i) {
+                    if (removed_pred(v[i])) {
+                        ++expected_removed;
+                    } else {
+                        expected_kept.push_back(static_cast<int>(i));
+                    }
+                }
+                size_t calls = 0;
+                Obj::num_move_assigned = 0;
+                const size_t removed = v.EraseUnorderedIf([&](const Obj& obj) {
+                    ++calls;
+                    return removed_pred(obj);
+                });
+                assert(removed == expected_removed && calls == size);
+                assert(static_cast<size_t>(Obj::num_move_assigned) <= removed);
+                std::vector<int> kept;
+                for (const Obj& obj : v) {
+                    kept.push_back(obj.id);
+                }
+                std::sort(kept.begin(), kept.end());
+                assert(kept == expected_kept);
+            }
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+    {
+        Vector<int, std::allocator<int>, AutoShrinkGrowth<>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        while (v.Size() > 10) {
+            v.EraseUnordered(v.begin());
+        }
+        // Каждый раз на место первого встаёт последний
+        assert(v.Capacity() < 64 && v[0] == 10 && v.Sum() == 55);
+        v.EraseUnorderedIf([](int x) {
+            return x < 6;
+        });
+        assert(v.Size() == 5 && v.Count(10) == 1 && v.Sum() == 40);
+        v.EraseIf([](int) {
+            return true;
+        });
+        assert(v.Size() == 0);
+    }
+}
+
+void Test24() {
+    {
+        CowVector<Obj> v(3);
+        v.Set(0, Obj(1));
+        Obj::num_copied = 0;
+        CowVector<Obj> copy(v);
+        CowVector<Obj> another;
+        another = copy;
+        assert(v.IsShared() && &std::as_const(v)[0] == &std::as_const(another)[0]);
+        assert(Obj::num_copied == 0);
+
+        // Первое изменение копирует блок один раз, остальные владельцы его не замечают
+        copy[1].id = 2;
+        assert(Obj::num_copied == 3 && !copy.IsShared() && v.IsShared());
+        copy[2].id = 3;
+        copy.EmplaceBack(4);
+        assert(Obj::num_copied == 3 && copy.Size() == 4);
+        assert(v[1].id == 0 && another[1].id == 0 && std::as_const(v)[0].id == 1);
+
+        // Аргумент ссылается на элемент разделяемого блока
+        another.EmplaceBack(std::as_const(another)[0]);
+        assert(another.Size() == 4 && another[3].id == 1 && v.Size() == 3);
+
+        copy.Erase(copy.cbegin());
+        assert(copy.Size() == 3 && copy[0].id == 2);
+        another.Clear();
+        assert(another.Size() == 0 && !v.IsShared());
+        another.PushBack(Obj(5));
+        another.Resize(3);
+        assert(another.Size() == 3 && another[0].id == 5);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        CowVector<std::string> config;
+        assert(config.Size() == 0 && config.begin() == config.end());
+        config.PushBack("a");
+        const auto snapshot = config.Snapshot();
+        config[0] = "b";
+        config.PushBack("c");
+        assert(snapshot.Size() == 1 && snapshot[0] == "a");
+        assert(config.Get().Count("c") == 1);
+
+        CowVector<std::string> restored(snapshot);
+        assert(restored.IsShared() && restored[0] == "a" && !restored.IsShared());
+
+        Vector<std::string> source(2);
+        source[1] = "x";
+        CowVector<std::string> adopted(std::move(source));
+        assert(adopted.Size() == 2 && adopted[1] == "x" && source.Size() == 0);
+    }
+    {
+        // Читатели в других потоках держат снимки, пока писатель публикует новые версии
+        CowVector<int> config(1000);
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([snapshot = config.Snapshot(), &stop] {
+                while (!stop) {
+                    assert(snapshot.Get().Sum() == 0);
+                    CowSnapshot<int> copy = snapshot;
+                    assert(copy.Size() == 1000);
+                }
+            });
+        }
+        for (int i = 1; i <= 100; ++i) {
+            config.Set(static_cast<size_t>(i), i);
+            const auto published = config.Snapshot();
+            assert(published.Get().Sum() == i * (i + 1) / 2);
+        }
+        stop = true;
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(!config.IsShared());
+    }
+    {
+        // Ссылка, выданная до снимка, не должна изменять снимок и копии
+        CowVector<int> v(3);
+        int& x = v[0];
+        const auto snapshot = v.Snapshot();
+        CowVector<int> copy = v;
+        x = 1;
+        assert(snapshot[0] == 0 && std::as_const(copy)[0] == 0 && std::as_const(v)[0] == 1);
+        assert(!v.IsShared() && !copy.IsShared());
+
+        // После Clear ссылки недействительны, и блок снова разделяется
+        v.Clear();
+        v.PushBack(7);
+        CowVector<int> shared = v;
+        assert(v.IsShared() && &std::as_const(v)[0] == &std::as_const(shared)[0]);
+        shared.Set(0, 8);
+        assert(std::as_const(v)[0] == 7 && std::as_const(shared)[0] == 8);
+
+        CowVector<int> moved = std::move(copy);
+        const auto moved_snapshot = moved.Snapshot();
+        assert(moved.IsShared() && moved_snapshot[0] == 0);
+    }
+}
+
+void Test25() {
+    {
+        // Рост не переносит элементы: адреса, полученные раньше, остаются действительными
+        SegmentedVector<Obj, std::allocator<Obj>, 4> v;
+        std::vector<Obj*> addresses;
+        for (int i = 0; i < 100; ++i) {
+            addresses.push_back(&v.EmplaceBack(i));
+        }
+        assert(v.Size() == 100 && v.Capacity() >= 100 && Obj::num_moved == 0 && Obj::num_copied == 0);
+        for (int i = 0; i < 100; ++i) {
+            assert(&v[static_cast<size_t>(i)] == addresses[static_cast<size_t>(i)] && v[static_cast<size_t>(i)].id == i);
+        }
+
+        // Аргумент ссылается на элемент вектора, вектор при этом получает новый сегмент
+        while (v.Size() < v.Capacity()) {
+            v.PushBack(Obj(0));
+        }
+        const size_t capacity = v.Capacity();
+        v.EmplaceBack(v[5]);
+        assert(v.Capacity() > capacity && v[v.Size() - 1].id == 5 && &v[5] == addresses[5]);
+
+        int expected = 0;
+        for (const Obj& obj : std::as_const(v)) {
+            if (expected < 100) {
+                assert(obj.id == expected);
+            }
+            ++expected;
+        }
+        assert(static_cast<size_t>(expected) == v.Size() && v.end() - v.begin() == expected);
+
+        SegmentedVector<Obj, std::allocator<Obj>, 4> copy(v);
+        assert(copy.Size() == v.Size() && copy[99].id == 99 && &copy[99] != &v[99]);
+        v.Resize(10);
+        assert(v.Size() == 10 && &v[9] == addresses[9] && copy.Size() > 100);
+        v.ShrinkToFit();
+        assert(v.Capacity() >= 10 && v.Capacity() < capacity);
+        v = std::move(copy);
+        assert(v.Size() > 100 && copy.Size() == 0);
+        v.PopBack();
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() > 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        // Итераторы произвольного доступа пересекают границы сегментов
+        SegmentedVector<int, std::allocator<int>, 2> v;
+        for (int i = 0; i < 50; ++i) {
+            v.PushBack(49 - i);
+        }
+        const auto it = std::find(v.cbegin(), v.cend(), 20);
+        assert(it - v.cbegin() == 29 && it[1] == 19 && *(it - 29) == 49 && *(v.begin() + 49) == 0);
+        auto back = v.end();
+        --back;
+        assert(*back == 0 && back > it);
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && v[0] == 0 && v[49] == 49);
+        assert(std::accumulate(v.begin(), v.end(), 0) == 49 * 50 / 2);
+
+        SegmentedVector<int> sized(100);
+        assert(sized.Size() == 100 && std::count(sized.begin(), sized.end(), 0) == 100);
+        sized.Reserve(1000);
+        assert(sized.Capacity() >= 1000 && sized.Size() == 100);
+    }
+    {
+        // Исключение при создании элемента не меняет размер
+        SegmentedVector<Obj, std::allocator<Obj>, 4> v(3);
+        Obj throwing;
+        throwing.throw_on_copy = true;
+        try {
+            v.PushBack(throwing);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+}
+
+void Test26() {
+    using namespace std::literals;
+    {
+        Vector<Obj> v;
+        v.EmplaceBack(1);
+        {
+            auto session = v.GrowBy(3);
+            assert(v.Capacity() >= 4 && session.Remaining() == 3);
+            const Obj* data = v.begin();
+            // Аргумент ссылается на элемент вектора: память в сеансе не перевыделяется
+            session.Emplace(v[0]);
+            session.Emplace(2, "two"s);
+            assert(v.Size() == 1 && session.Remaining() == 1 && v.begin() == data);
+        }
+        assert(v.Size() == 3 && v[1].id == 1 && v[2].id == 2 && v[2].name == "two"s);
+
+        // Исключение откатывает только элементы текущего сеанса
+        const size_t capacity = v.Capacity();
+        Obj throwing(7);
+        throwing.throw_on_copy = true;
+        try {
+            auto session = v.GrowBy(3);
+            session.Emplace(3);
+            session.Commit();
+            session.Emplace(4);
+            session.Emplace(throwing);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && v[3].id == 3 && v.Capacity() >= capacity);
+        assert(Obj::GetAliveObjectCount() == 5);
+
+        // Вместимость растёт по политике роста, а не ровно на count
+        v.GrowBy(v.Capacity() - v.Size() + 1);
+        assert(v.Capacity() >= 2 * capacity && v.Size() == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        SmallVector<std::string, 2> v;
+        {
+            auto session = v.GrowBy(2);
+            session.Emplace("a");
+            session.Emplace("b");
+        }
+        assert(v.Capacity() == 2 && v.Size() == 2 && v[1] == "b");
+        auto session = v.GrowBy(10);
+        for (int i = 0; i < 10; ++i) {
+            session.Emplace(std::to_string(i));
+        }
+        session.Commit();
+        assert(v.Capacity() >= 12 && v.Size() == 12 && v[11] == "9" && session.Remaining() == 0);
+    }
+    {
+        // Commit сообщает статистике новый размер: незанятая вместимость уменьшается
+        using SiteVector = Vector<int, std::allocator<int>, DoublingGrowth, RawMemory<int>, CallSiteStats>;
+        SiteVector v(CallSiteStats::Here());
+        {
+            auto session = v.GrowBy(8);
+            for (int i = 0; i < 5; ++i) {
+                session.Emplace(i);
+            }
+        }
+        assert(v.Size() == 5 && v.GetStats().wasted_bytes == (v.Capacity() - 5) * sizeof(int));
+    }
+}
+
+void Test27() {
+    {
+        using Bounded = CheckedVector<int, BoundsChecks>;
+        static_assert(std::is_same_v<Bounded::iterator, int*>);
+        Bounded v(3);
+        v[2] = 5;
+        assert(!Crashes([&v] { v[2] = 1; }));
+        assert(Crashes([&v] { v[3] = 1; }));
+        assert(Crashes([&v] { v.Insert(v.end() + 1, 1); }));
+        assert(Crashes([&v] { v.Erase(v.end()); }));
+        assert(Crashes([&v] { v.EraseRange(v.begin() + 2, v.begin() + 1); }));
+        assert(Crashes([] { Bounded().MinMax(); }));
+        assert(Crashes([&v] {
+            auto session = v.GrowBy(1);
+            session.Emplace(1);
+            session.Emplace(2);
+        }));
+        assert(v.Size() == 3 && v[2] == 5);
+    }
+    {
+        using Debug = CheckedVector<std::string, DebugChecks>;
+        static_assert(std::random_access_iterator<Debug::iterator>);
+        static_assert(std::random_access_iterator<Debug::const_iterator>);
+        static_assert(!is_trivially_relocatable_v<Debug>);
+        Debug v;
+        v.Reserve(2);
+        v.PushBack("b");
+        v.PushBack("a");
+        auto it = v.begin();
+        assert(!Crashes([&it] { assert(*it == "b"); }));
+
+        // Перевыделение памяти делает прежние итераторы недействительными
+        v.PushBack("c");
+        assert(Crashes([&it] { assert(!it->empty()); }));
+        assert(Crashes([&v, it] { v.Erase(it); }));
+        assert(Crashes([&v] { *v.end() = "x"; }));
+        assert(Crashes([] { *CheckedVector<int, DebugChecks>::iterator() = 1; }));
+
+        std::sort(v.begin(), v.end());
+        assert(v[0] == "a" && v[2] == "c" && *(v.cend() - 1) == "c");
+        Debug::const_iterator found = v.Find("b");
+        assert(found - v.cbegin() == 1 && found[1] == "c");
+        it = v.Insert(v.begin() + 1, "ab");
+        assert(*it == "ab" && v.Size() == 4);
+        it = v.Erase(it);
+        assert(*it == "b" && std::count(v.begin(), v.end(), "b") == 1);
+        assert(v.EraseIf([](const std::string& s) { return s == "a"; }) == 1 && v[0] == "b");
+
+        // Итераторы другого вектора и итераторы после обмена отвергаются
+        Debug other(1);
+        assert(Crashes([&v, &other] { v.Erase(other.begin()); }));
+        auto before_swap = v.begin();
+        v.Swap(other);
+        assert(Crashes([before_swap] { assert(before_swap->empty()); }));
+        assert(other.Size() == 2 && v.Size() == 1);
+        size_t total = 0;
+        for (const std::string& s : other) {
+            total += s.size();
+        }
+        assert(total == 2);
+    }
+}
+
+void Test28() {
+    using namespace std::literals;
+    // Таблица строится во время компиляции и хранится в готовом виде
+    static constexpr auto kSquares = ToStaticArray<[] {
+        Vector<int> v;
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack(i * i);
+        }
+        return v;
+    }>();
+    static_assert(kSquares.size() == 16 && kSquares[0] == 0 && kSquares[15] == 225);
+
+    static_assert([] {
+        Vector<int> v(3);
+        v.Reserve(10);
+        v.Insert(v.begin(), 5);
+        const int tail[] = {7, 8, 9};
+        v.InsertRange(v.begin() + 1, tail, tail + 3);
+        v.Erase(v.begin() + 2);
+        v.EraseRange(v.end() - 2, v.end());
+        v.EmplaceBack(4);
+        v.EraseUnordered(v.begin());
+        Vector<int> copy = v;
+        copy.Resize(8);
+        copy.ShrinkToFit();
+        Vector<int> moved = std::move(copy);
+        moved.EraseIf([](int x) {
+            return x == 0;
+        });
+        // {4, 7, 9}: SIMD-ядра при вычислении во время компиляции не используются
+        return v.Size() == 4 && moved.Size() == 3 && moved.Sum() == 20 && *moved.Find(9) == 9
+            && moved.MinMax() == std::pair{4, 9} && moved.Count(7) == 1 && moved != v;
+    }());
+
+    static_assert([] {
+        Vector<std::string> v;
+        v.EmplaceBack("table");
+        v.Insert(v.begin(), "long string that does not fit into SSO buffer"s);
+        v.Resize(5);
+        v.Erase(v.begin() + 2);
+        Vector<std::string> other;
+        other = v;
+        return other.Size() == 4 && other[1] == "table" && other[0].size() > 40 && other[3].empty();
+    }());
+
+    // Проверки DebugChecks работают и во время компиляции
+    static_assert([] {
+        CheckedVector<int, DebugChecks> v;
+        v.PushBack(1);
+        v.PushBack(2);
+        auto it = v.begin() + 1;
+        std::sort(v.begin(), v.end(), std::greater<>());
+        return *it == 1 && it[-1] == 2;
+    }());
+}
+
+void Test29() {
+    using namespace std::literals;
+    static_assert(std::is_trivially_copyable_v<InplaceVector<int, 8>>);
+    static_assert(!std::is_trivially_copyable_v<InplaceVector<std::string, 8>>);
+    static_assert(is_trivially_relocatable_v<InplaceVector<std::unique_ptr<int>, 2>>);
+    static_assert(std::is_same_v<StaticVector<int, 4>, InplaceVector<int, 4>>);
+    {
+        InplaceVector<int, 4> v;
+        for (int i = 0; i < 4; ++i) {
+            assert(v.TryPushBack(i) != nullptr);
+        }
+        assert(v.IsFull() && v.TryEmplaceBack(4) == nullptr && v.Size() == 4);
+        try {
+            v.PushBack(4);
+            assert(false);
+        } catch (const std::bad_alloc&) {
+        }
+        auto copy = v;
+        auto it = copy.Erase(copy.begin() + 1);
+        assert(*it == 2 && copy.Size() == 3);
+        copy.Insert(copy.begin(), 9);
+        assert((copy == InplaceVector<int, 4>(std::move(copy))));
+        assert(copy[0] == 9 && copy[1] == 0 && copy[3] == 3 && v[1] == 1);
+        copy.EraseRange(copy.begin(), copy.begin() + 2);
+        const int tail[] = {7, 8};
+        copy.InsertRange(copy.begin() + 1, tail, tail + 2);
+        assert(copy.Size() == 4 && copy[0] == 2 && copy[1] == 7 && copy[2] == 8 && copy[3] == 3);
+        copy.Resize(1);
+        copy.Resize(2);
+        assert(copy[1] == 0);
+    }
+    {
+        InplaceVector<Obj, 5> v(2);
+        v.EmplaceBack(1, "one"s);
+        // Аргумент ссылается на элемент вектора
+        v.Insert(v.begin(), v[2]);
+        assert(v.Size() == 4 && v[0].id == 1 && v[1].id == 0 && v[3].id == 1);
+        Obj throwing(7);
+        throwing.throw_on_copy = true;
+        try {
+            v.Insert(v.begin() + 1, throwing);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && Obj::GetAliveObjectCount() == 5);
+        try {
+            v.Resize(6);
+            assert(false);
+        } catch (const std::bad_alloc&) {
+        }
+
+        InplaceVector<Obj, 5> other;
+        other.EmplaceBack(5);
+        v.Swap(other);
+        assert(v.Size() == 1 && v[0].id == 5 && other.Size() == 4 && other[3].id == 1);
+        v = other;
+        assert(v.Size() == 4 && v[0].id == 1);
+        other = std::move(v);
+        other.Erase(other.begin());
+        other.Clear();
+        assert(Obj::GetAliveObjectCount() == 5);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+}
+
+void Test30() {
+    // Копирующее присваивание в буфер достаточной вместимости: элементы присваиваются,
+    // дописываются за прежним концом или уничтожаются, но никогда не создаются поверх живых
+    Obj::ResetCounters();
+    {
+        const size_t kPool = 8;
+        Vector<Vector<Obj>> pool(kPool);
+        Vector<size_t> expected_size(kPool);
+        uint32_t seed = 12345;
+        auto next = [&seed](uint32_t bound) {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) % bound;
+        };
+        for (size_t i = 0; i < kPool; ++i) {
+            pool[i].Reserve(64);
+        }
+        for (int step = 0; step < 2000; ++step) {
+            Vector<Obj>& from = pool[next(kPool)];
+            Vector<Obj>& to = pool[next(kPool)];
+            if (next(3) == 0) {
+                const size_t size = next(64);
+                from.Resize(size);
+                for (size_t i = 0; i < size; ++i) {
+                    from[i].id = static_cast<int>(step * 100 + i);
+                }
+                continue;
+            }
+            const size_t to_capacity = to.Capacity();
+            const int assigned = Obj::num_assigned;
+            const int copied = Obj::num_copied;
+            const int destroyed = Obj::num_destroyed;
+            const size_t old_size = to.Size();
+            to = from;
+            assert(to.Size() == from.Size() && to.Capacity() == to_capacity);
+            for (size_t i = 0; i < from.Size(); ++i) {
+                assert(to[i].id == from[i].id);
+            }
+            if (&from != &to) {
+                const size_t common = std::min(old_size, from.Size());
+                assert(Obj::num_assigned - assigned == static_cast<int>(common));
+                assert(Obj::num_copied - copied == static_cast<int>(from.Size() - common));
+                assert(Obj::num_destroyed - destroyed == static_cast<int>(old_size - common));
+            }
+            size_t alive = 0;
+            for (const Vector<Obj>& v : pool) {
+                alive += v.Size();
+            }
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(alive));
+        }
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        // Тривиально копируемые элементы копируются одним memcpy
+        Vector<int> small(3);
+        small[2] = 7;
+        Vector<int> big(10);
+        std::iota(big.begin(), big.end(), 1);
+        small.Reserve(16);
+        const int* data = small.begin();
+        small = big;
+        assert(small.begin() == data && small.Size() == 10 && small[9] == 10);
+        big.Resize(2);
+        small = big;
+        assert(small.Size() == 2 && small[1] == 2 && small.Capacity() == 16);
+    }
+}
+
+void Test31() {
+    {
+        // Хвост тривиально перемещаемых элементов сдвигается memmove, аргумент может ссылаться на него
+        const int expected[] = {4, 0, 3, 1, 2, 3, 4};
+        Vector<int> v;
+        v.Reserve(8);
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin() + 1, v[3]);
+        v.Emplace(v.begin(), v[5]);
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+
+        Vector<std::unique_ptr<int>> ptrs;
+        ptrs.Reserve(3);
+        ptrs.PushBack(std::make_unique<int>(1));
+        ptrs.PushBack(std::make_unique<int>(2));
+        ptrs.Emplace(ptrs.begin(), new int(0));
+        assert(*ptrs[0] == 0 && *ptrs[1] == 1 && *ptrs[2] == 2);
+    }
+}
+
+void Test32() {
+    {
+        using namespace std::literals;
+        GapVector<std::string> text;
+        for (char c : "hello world"s) {
+            text.PushBack(std::string(1, c));
+        }
+        // Вставки подряд с одной позиции не переносят разрыв
+        text.Insert(5, ","s);
+        assert(text.GapPosition() == 6);
+        text.Insert(6, " dear"s);
+        text.Emplace(7, text[0]);
+        assert(text.Size() == 14 && text.GapPosition() == 8);
+        text.Erase(7);
+        text.EraseRange(0, 1);
+        text.Insert(0, "H"s);
+        assert(text.GapPosition() == 1);
+        std::string joined;
+        for (const std::string& s : text) {
+            joined += s;
+        }
+        assert(joined == "Hello, dear world"s);
+
+        GapVector<std::string> copy = text;
+        assert(copy.Size() == text.Size() && copy.Capacity() == copy.Size() && copy[6] == " dear"s);
+        copy.PopBack();
+        copy.EmplaceBack(3, '!');
+        assert(copy[copy.Size() - 1] == "!!!"s && text[text.Size() - 1] == "d"s);
+        text = std::move(copy);
+        assert(text.Size() == 13 && text[12] == "!!!"s);
+        text.Clear();
+        assert(text.Size() == 0 && text.Capacity() > 0);
+    }
+    {
+        // Разрыв переходит между случайными позициями; содержимое сверяется с std::vector
+        Obj::ResetCounters();
+        GapVector<Obj> v(3);
+        std::vector<int> model(3);
+        uint32_t seed = 7;
+        for (int step = 0; step < 3000; ++step) {
+            seed = seed * 1103515245 + 12345;
+            const size_t index = (seed >> 16) % (model.size() + 1);
+            if (seed % 3 != 0 || model.empty()) {
+                v.Emplace(index, step);
+                model.insert(model.begin() + index, step);
+            } else {
+                const size_t last = std::min(model.size(), index + 1 + step % 3);
+                const size_t first = std::min(index, last - 1);
+                v.EraseRange(first, last);
+                model.erase(model.begin() + first, model.begin() + last);
+            }
+            assert(v.Size() == model.size() && Obj::GetAliveObjectCount() == static_cast<int>(model.size()));
+        }
+        assert(std::equal(v.begin(), v.end(), model.begin(), model.end(), [](const Obj& obj, int id) {
+            return obj.id == id;
+        }));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+}
+
+void Test33() {
+    using namespace std::literals;
+    {
+        Vector<int> v(10);
+        std::iota(v.begin(), v.end(), 0);
+        std::span<int> middle = v.Subspan(2, 3);
+        assert(middle.data() == v.Data() + 2 && middle.size() == 3);
+        middle[0] = 20;
+        assert(v[2] == 20 && v.Subspan(7).size() == 3 && v.Subspan(10).empty());
+        const Vector<int>& cv = v;
+        static_assert(std::is_same_v<decltype(cv.Subspan(0)), std::span<const int>>);
+        assert(SumOf(v) == 45 + 18 && SumOf(cv.Subspan(8)) == 17);
+
+        VectorView view = v;
+        static_assert(std::is_same_v<decltype(view), VectorView<int>>);
+        assert(view.Size() == 10 && view[2] == 20 && *view.Find(9) == 9 && view.Find(42) == view.end());
+        assert(view.Subview(1, 2) == VectorView<int>(v.Subspan(1, 2)) && view.Subview(4).Size() == 6);
+        assert(CountZeros(v) == 1 && CountZeros(view.Subview(1)) == 0 && CountZeros({}) == 0);
+        static_assert(std::is_trivially_copyable_v<VectorView<std::string>>);
+
+        using Bounded = CheckedVector<int, BoundsChecks>;
+        Bounded b(3);
+        assert(!Crashes([&b] { (void)b.Subspan(1, 2); }));
+        assert(Crashes([&b] { (void)b.Subspan(4); }));
+        assert(Crashes([&b] { (void)b.Subspan(1, 3); }));
+    }
+    {
+        // Буфер переходит между векторами и "C API" без копирования элементов
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(8);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2, "two"s);
+        const Obj* data = v.Data();
+        auto [buffer, size] = v.Release();
+        assert(v.Size() == 0 && v.Capacity() == 0 && size == 2 && buffer.Capacity() == 8);
+        assert(buffer.GetAddress() == data && Obj::GetAliveObjectCount() == 2);
+
+        const size_t capacity = buffer.Capacity();
+        Obj* raw = buffer.Release();
+        raw[1].id = 3;
+        std::allocator<Obj> alloc;
+        Vector<Obj> adopted(3);
+        adopted.Adopt(RawMemory<Obj>(raw, capacity, alloc), size);
+        assert(adopted.Data() == data && adopted.Size() == 2 && adopted.Capacity() == 8);
+        assert(adopted[1].id == 3 && adopted[1].name == "two"s);
+        assert(Obj::num_copied == 0 && Obj::num_moved == 0 && Obj::GetAliveObjectCount() == 2);
+        adopted.EmplaceBack(4);
+        assert(adopted.Data() == data);
+        auto released = adopted.Release();
+        std::destroy_n(released.first.GetAddress(), released.second);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        SmallVector<std::string, 2> v;
+        v.PushBack("inline");
+        RawMemory<std::string> buffer(4);
+        std::construct_at(buffer.GetAddress(), "heap");
+        v.Adopt(std::move(buffer), 1);
+        assert(v.Size() == 1 && v[0] == "heap" && v.Capacity() == 4);
+        v.PushBack("more");
+        assert(v[1] == "more");
+    }
+}
+
+void Test34() {
+    struct Record {
+        uint32_t id;
+        float value;
+    };
+    const auto path = std::filesystem::temp_directory_path() / ("vector_io_test_" + std::to_string(getpid()));
+    const size_t SIZE = 10'000;
+    {
+        Vector<Record> records(SIZE);
+        for (uint32_t i = 0; i < SIZE; ++i) {
+            records[i] = Record{i, static_cast<float>(i) / 4};
+        }
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        assert(fd >= 0);
+        const size_t bytes = SIZE * sizeof(Record);
+        assert(::write(fd, records.Data(), bytes) == static_cast<ssize_t>(bytes));
+        // Лишние байты обрывают последний элемент
+        assert(::write(fd, "xyz", 3) == 3);
+        ::close(fd);
+    }
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        assert(fd >= 0);
+        Vector<Record> v;
+        v.PushBack(Record{42, 0});
+        assert(ReadInto(v, fd, 100) == 100 && v.Size() == 101 && v[0].id == 42 && v[100].id == 99);
+        assert(ReadInto(v, fd, 1000) == 1000 && v[1100].value == 1099.0f / 4);
+        try {
+            ReadInto(v, fd, SIZE);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE + 1 && v[SIZE].id == SIZE - 1);
+        assert(ReadInto(v, fd, 10) == 0 && v.Size() == SIZE + 1);
+        ::close(fd);
+
+        Vector<std::byte> bytes;
+        try {
+            ReadInto(bytes, fd, 16);
+            assert(false);
+        } catch (const std::system_error& e) {
+            assert(e.code().value() == EBADF);
+        }
+        assert(bytes.Size() == 0);
+    }
+    {
+        // Разбор порций идёт, пока следующая порция читается из канала
+        int fds[2];
+        assert(::pipe(fds) == 0);
+        std::thread writer([fd = fds[1]] {
+            Vector<uint32_t> data(100'000);
+            std::iota(data.begin(), data.end(), 0);
+            const char* from = reinterpret_cast<const char*>(data.Data());
+            size_t left = data.Size() * sizeof(uint32_t);
+            while (left > 0) {
+                // Запись частями, не кратными элементу
+                const ssize_t written = ::write(fd, from, std::min<size_t>(left, 1001));
+                assert(written > 0);
+                from += written;
+                left -= written;
+            }
+            ::close(fd);
+        });
+        uint64_t sum = 0;
+        size_t chunks = 0;
+        uint32_t expected = 0;
+        const size_t total = ReadChunked<uint32_t>(fds[0], 4096, [&](std::span<const uint32_t> chunk) {
+            assert(chunk.size() == 4096 || expected + chunk.size() == 100'000);
+            for (const uint32_t value : chunk) {
+                assert(value == expected++);
+                sum += value;
+            }
+            ++chunks;
+        });
+        writer.join();
+        ::close(fds[0]);
+        assert(total == 100'000 && chunks == 25 && sum == uint64_t{99'999} * 100'000 / 2);
+    }
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        try {
+            ReadChunked<std::byte>(fd, 64, [](std::span<const std::byte>) {
+                throw std::logic_error("stop");
+            });
+            assert(false);
+        } catch (const std::logic_error&) {
+        }
+        ::close(fd);
+    }
+    std::filesystem::remove(path);
+}
+
+void Test35() {
+    using namespace std::literals;
+    {
+        // Повторы ключей удаляются при построении, остаётся первое значение
+        Vector<std::pair<std::string, int>> items;
+        for (const auto& [key, value] : {std::pair{"pear"s, 1}, {"apple"s, 2}, {"pear"s, 3}, {"fig"s, 4}, {"apple"s, 5}}) {
+            items.EmplaceBack(key, value);
+        }
+        SortedFlatMap<std::string, int> map(std::move(items));
+        assert(map.Size() == 3 && map.begin()->first == "apple"s && (map.end() - 1)->first == "pear"s);
+        assert(*map.Find("pear"s) == 1 && *map.Find("apple"sv) == 2 && map.Find("plum"sv) == nullptr);
+        assert(!map.Emplace("fig"s, 40).second && *map.Find("fig"sv) == 4);
+        map["banana"s] = 6;
+        ++map["fig"s];
+        assert(map.Size() == 4 && map.Entries()[1].first == "banana"s && *map.Find("fig"sv) == 5);
+        assert(map.Erase("apple"sv) && !map.Erase("apple"sv) && !map.Contains("apple"sv));
+        assert(map.begin()->first == "banana"s);
+
+        Vector<int> keys;
+        for (const int key : {5, 3, 5, 1, 3, 9}) {
+            keys.PushBack(key);
+        }
+        SortedFlatSet<int, std::greater<>> set(std::move(keys));
+        const int expected[] = {9, 5, 3, 1};
+        assert(std::equal(set.begin(), set.end(), std::begin(expected), std::end(expected)));
+        assert(set.Insert(4) && !set.Insert(4) && set.Size() == 5 && set.Entries()[2] == 4);
+    }
+    {
+        FlatHashMap<std::string, std::string> map;
+        assert(map.Find("a"s) == nullptr && !map.Erase("a"s) && map.BucketCount() == 0);
+        map["one"s] = "1"s;
+        map.Emplace("two"s, 1, '2');
+        assert(!map.Emplace("one"s, "uno"s).second && *map.Find("one"s) == "1"s);
+        // Элементы хранятся в порядке вставки
+        assert(map.Size() == 2 && map.begin()->first == "one"s && map.Entries()[1].second == "2"s);
+        FlatHashMap<std::string, std::string> copy = map;
+        assert(map.Erase("one"s) && map.begin()->first == "two"s && *copy.Find("one"s) == "1"s);
+        FlatHashMap<std::string, std::string> moved = std::move(copy);
+        assert(copy.Size() == 0 && copy.Find("one"s) == nullptr && moved.Size() == 2);
+        copy["again"s] = "yes"s;
+        assert(*copy.Find("again"s) == "yes"s);
+    }
+    {
+        // Вставки и удаления случайных ключей сверяются с std::map; удалённые ячейки
+        // заставляют таблицу перестраиваться без роста
+        FlatHashMap<uint64_t, uint64_t> map;
+        FlatHashSet<uint64_t> set;
+        std::map<uint64_t, uint64_t> model;
+        uint32_t seed = 11;
+        for (int step = 0; step < 20'000; ++step) {
+            seed = seed * 1103515245 + 12345;
+            // Ключи кратны 1024: младшие биты хеша у них совпадают
+            const uint64_t key = ((seed >> 16) % 500) * 1024;
+            if (seed & 0x100) {
+                map[key] = step;
+                model[key] = step;
+                set.Insert(key);
+            } else {
+                assert(map.Erase(key) == (model.erase(key) == 1));
+                set.Erase(key);
+            }
+            assert(map.Size() == model.size() && set.Size() == model.size());
+        }
+        assert(map.BucketCount() <= 1024);
+        for (uint64_t key = 0; key < 500 * 1024; key += 512) {
+            const auto it = model.find(key);
+            const uint64_t* value = map.Find(key);
+            assert(it == model.end() ? value == nullptr : *value == it->second);
+            assert(set.Contains(key) == (it != model.end()));
+        }
+        uint64_t sum = 0;
+        for (const auto& [key, value] : map) {
+            sum += value;
+        }
+        assert(sum == std::accumulate(model.begin(), model.end(), uint64_t{0}, [](uint64_t acc, const auto& kv) {
+                   return acc + kv.second;
+               }));
+        map.Clear();
+        assert(map.Size() == 0 && map.Find(uint64_t{0}) == nullptr && map.BucketCount() > 0);
+    }
+    {
+        Vector<int> keys(1000);
+        std::iota(keys.begin(), keys.end(), -500);
+        keys.PushBack(0);
+        FlatHashSet<int> set(std::move(keys));
+        assert(set.Size() == 1000 && set.Contains(-500) && set.Contains(499) && !set.Contains(500));
+        assert(set.BucketCount() == 2048);
     }
 }
 
@@ -648,9 +2971,38 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
+        return 1;
     }
     std::cout << "OK" << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,317 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <new>
+#include <source_location>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace detail {
+
+// FNV-1a от имени типа в сигнатуре функции: совпадает у одного компилятора
+// независимо от запуска, в отличие от std::type_info::hash_code
+template <typename T>
+constexpr uint64_t TypeHash() noexcept {
+    const std::string_view name = std::source_location::current().function_name();
+    uint64_t hash = 0xcbf2'9ce4'8422'2325;
+    for (const char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x0000'0100'0000'01b3;
+    }
+    return hash;
+}
+
+}  // namespace detail
+
+// Вектор тривиально копируемых элементов, хранящихся в файле, отображённом в память (MAP_SHARED).
+// Файл начинается с заголовка: сигнатура, версия формата, хеш типа, число элементов и вместимость.
+// Повторное открытие файла лишь отображает его, не читая и не разбирая данные.
+// Вместимость растёт по политике Growth через ftruncate и mremap, а Flush() сбрасывает изменения на диск.
+// Файл блокируется (flock) на время жизни вектора: одновременно его может открыть только один объект
+template <typename T, typename Growth = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "элементы хранятся в файле побайтово");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr uint32_t kFormatVersion = 1;
+
+    // Открывает файл path или создаёт пустой вектор, если файла нет либо он пуст.
+    // Файл другого формата, версии или типа элементов не открывается
+    explicit MappedVector(const std::filesystem::path& path) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        try {
+            if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+                ThrowSystemError("flock");
+            }
+            struct stat st {};
+            if (fstat(fd_, &st) != 0) {
+                ThrowSystemError("fstat");
+            }
+            if (st.st_size == 0) {
+                Map(MappedBytes(0));
+                *header_ = Header{};
+                header_->capacity = (mapped_bytes_ - kDataOffset) / sizeof(T);
+            } else {
+                if (static_cast<size_t>(st.st_size) < kDataOffset) {
+                    throw std::runtime_error("MappedVector: file is too small");
+                }
+                mapped_bytes_ = static_cast<size_t>(st.st_size);
+                Map(0);
+                Validate();
+            }
+        } catch (...) {
+            Unmap();
+            close(fd_);
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector& other) = delete;
+    MappedVector& operator=(const MappedVector& other) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , header_(std::exchange(other.header_, nullptr))
+        , mapped_bytes_(std::exchange(other.mapped_bytes_, 0)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            MappedVector old(std::move(*this));
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    // Изменения, не сброшенные Flush(), записывает ядро в своё время
+    ~MappedVector() {
+        if (fd_ >= 0) {
+            Unmap();
+            close(fd_);
+        }
+    }
+
+    iterator begin() noexcept {
+        return Data();
+    }
+
+    iterator end() noexcept {
+        return Data() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+
+    const_iterator end() const noexcept {
+        return Data() + Size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Remap(new_capacity);
+        }
+    }
+
+    // Новые элементы инициализируются значением T{}
+    void Resize(size_t new_size) {
+        if (new_size > Capacity()) {
+            Remap(NextCapacity(new_size));
+        }
+        if (new_size > Size()) {
+            std::uninitialized_value_construct(end(), Data() + new_size);
+        }
+        header_->size = new_size;
+    }
+
+    // Аргументы могут ссылаться на элементы вектора: элемент создаётся до перераспределения
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        const T value(std::forward<Types>(values)...);
+        if (Size() == Capacity()) {
+            Remap(NextCapacity(Size() + 1));
+        }
+        T* elem = new (end()) T(value);
+        ++header_->size;
+        return *elem;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() noexcept {
+        assert(Size() > 0);
+        --header_->size;
+    }
+
+    // Вместимость и размер файла сохраняются
+    void Clear() noexcept {
+        header_->size = 0;
+    }
+
+    // Синхронно записывает заголовок и элементы на диск
+    void Flush() {
+        if (msync(header_, mapped_bytes_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+    size_t Size() const noexcept {
+        return static_cast<size_t>(header_->size);
+    }
+
+    size_t Capacity() const noexcept {
+        return static_cast<size_t>(header_->capacity);
+    }
+
+    const T* Data() const noexcept {
+        return const_cast<MappedVector&>(*this).Data();
+    }
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(header_) + kDataOffset);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    void Swap(MappedVector& other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(header_, other.header_);
+        std::swap(mapped_bytes_, other.mapped_bytes_);
+    }
+
+private:
+    static constexpr uint64_t kMagic = 0x5443'4556'5041'4d00;  // "\0MAPVECT"
+
+    struct Header {
+        uint64_t magic = kMagic;
+        uint32_t version = kFormatVersion;
+        uint32_t elem_size = sizeof(T);
+        uint64_t type_hash = detail::TypeHash<T>();
+        uint64_t size = 0;
+        uint64_t capacity = 0;
+    };
+
+    // Элементы начинаются с отдельной кеш-линии после заголовка
+    static constexpr size_t kDataOffset = std::max<size_t>({64, alignof(T), sizeof(Header)});
+
+    static size_t PageSize() noexcept {
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page_size;
+    }
+
+    // Размер файла под capacity элементов, кратный странице
+    static size_t MappedBytes(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() - kDataOffset - PageSize()) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = kDataOffset + capacity * sizeof(T);
+        return (bytes + PageSize() - 1) / PageSize() * PageSize();
+    }
+
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    size_t NextCapacity(size_t required) const noexcept {
+        return Growth::NextCapacity(Capacity(), required, sizeof(T));
+    }
+
+    // Отображает файл, предварительно установив его размер bytes (0 — оставить текущий)
+    void Map(size_t bytes) {
+        if (bytes != 0) {
+            if (ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+                ThrowSystemError("ftruncate");
+            }
+            mapped_bytes_ = bytes;
+        }
+        void* addr = mmap(nullptr, mapped_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            mapped_bytes_ = 0;
+            ThrowSystemError("mmap");
+        }
+        header_ = static_cast<Header*>(addr);
+    }
+
+    void Unmap() noexcept {
+        if (header_) {
+            munmap(header_, mapped_bytes_);
+            header_ = nullptr;
+        }
+    }
+
+    void Validate() const {
+        if (header_->magic != kMagic) {
+            throw std::runtime_error("MappedVector: not a vector file");
+        }
+        if (header_->version != kFormatVersion) {
+            throw std::runtime_error("MappedVector: unsupported format version");
+        }
+        if (header_->elem_size != sizeof(T) || header_->type_hash != detail::TypeHash<T>()) {
+            throw std::runtime_error("MappedVector: element type mismatch");
+        }
+        if (header_->size > header_->capacity || MappedBytes(header_->capacity) > mapped_bytes_) {
+            throw std::runtime_error("MappedVector: corrupted header");
+        }
+    }
+
+    // Вместимость округляется вверх до целых страниц файла. При ошибке отображение не меняется
+    void Remap(size_t capacity) {
+        const size_t new_bytes = MappedBytes(capacity);
+        if (ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+        void* addr = mremap(header_, mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+        if (addr == MAP_FAILED) {
+            const int error = errno;
+            // Возвращаем прежний размер файла, которым ограничено отображение
+            [[maybe_unused]] const int rc = ftruncate(fd_, static_cast<off_t>(mapped_bytes_));
+            throw std::system_error(error, std::generic_category(), "mremap");
+        }
+        header_ = static_cast<Header*>(addr);
+        mapped_bytes_ = new_bytes;
+        header_->capacity = (new_bytes - kDataOffset) / sizeof(T);
+    }
+
+    int fd_ = -1;
+    Header* header_ = nullptr;
+    size_t mapped_bytes_ = 0;
+};
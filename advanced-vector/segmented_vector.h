@@ -0,0 +1,334 @@
+#pragma once
+#include "vector.h"
+
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// Вектор со стабильными адресами элементов. Элементы хранятся в сегментах RawMemory,
+// размеры которых растут геометрически: сегмент k вмещает FirstSegmentSize << k элементов.
+// При росте добавляется новый сегмент, а существующие элементы никогда не переносятся,
+// поэтому указатели и ссылки на них остаются действительными до удаления самих элементов.
+// Номер сегмента и смещение в нём вычисляются по индексу несколькими битовыми операциями
+template <typename T, typename Alloc = std::allocator<T>, size_t FirstSegmentSize = 32>
+class SegmentedVector {
+    static_assert(std::has_single_bit(FirstSegmentSize), "размер первого сегмента должен быть степенью двойки");
+
+    using Segment = RawMemory<T, Alloc>;
+    using SegmentAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Segment>;
+
+    template <bool Const>
+    class Iterator;
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using allocator_type = Alloc;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+        , segments_(SegmentAlloc(alloc)) {
+    }
+
+    explicit SegmentedVector(size_t size, const Alloc& alloc = Alloc())
+        : SegmentedVector(alloc) {
+        Resize(size);
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.alloc_)) {
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : alloc_(other.alloc_)
+        , segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            SegmentedVector old(std::move(*this));
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size_);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Выделяет сегменты, пока их общая вместимость не достигнет new_capacity
+    void Reserve(size_t new_capacity) {
+        while (Capacity() < new_capacity) {
+            AddSegment();
+        }
+    }
+
+    // Новые элементы инициализируются значением
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        while (size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    // Аргументы могут ссылаться на элементы вектора: они не переносятся при росте
+    template <typename... Types>
+    T& EmplaceBack(Types&&... values) {
+        if (size_ == Capacity()) {
+            AddSegment();
+        }
+        T* elem = new (Address(size_)) T(std::forward<Types>(values)...);
+        ++size_;
+        return *elem;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(Address(size_));
+    }
+
+    // Вместимость сохраняется
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+    // Освобождает сегменты, в которых не осталось элементов
+    void ShrinkToFit() noexcept {
+        while (segments_.Size() != 0 && SegmentStart(segments_.Size() - 1) >= size_) {
+            segments_.PopBack();
+        }
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return SegmentStart(segments_.Size());
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Address(index);
+    }
+
+    allocator_type GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        segments_.Swap(other.segments_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    static constexpr size_t SegmentSize(size_t k) noexcept {
+        return FirstSegmentSize << k;
+    }
+
+    // Индекс первого элемента сегмента k
+    static constexpr size_t SegmentStart(size_t k) noexcept {
+        return FirstSegmentSize * ((size_t{1} << k) - 1);
+    }
+
+    // Номер сегмента и смещение в нём для элемента index
+    static constexpr std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t k = std::bit_width(index / FirstSegmentSize + 1) - 1;
+        return {k, index - SegmentStart(k)};
+    }
+
+    T* Address(size_t index) noexcept {
+        const auto [k, offset] = Locate(index);
+        return segments_[k] + offset;
+    }
+
+    void AddSegment() {
+        segments_.EmplaceBack(SegmentSize(segments_.Size()), alloc_);
+    }
+
+    [[no_unique_address]] Alloc alloc_;
+    Vector<Segment, SegmentAlloc> segments_;
+    size_t size_ = 0;
+};
+
+// Итератор хранит указатель на текущий сегмент и пересчитывает его только на границах сегментов
+template <typename T, typename Alloc, size_t FirstSegmentSize>
+template <bool Const>
+class SegmentedVector<T, Alloc, FirstSegmentSize>::Iterator {
+    using Owner = std::conditional_t<Const, const SegmentedVector, SegmentedVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    Iterator() = default;
+
+    Iterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+        Locate();
+    }
+
+    // Неконстантный итератор преобразуется в константный
+    operator Iterator<true>() const noexcept requires(!Const) {
+        return Iterator<true>(owner_, index_);
+    }
+
+    reference operator*() const noexcept {
+        assert(index_ < owner_->size_);
+        return *ptr_;
+    }
+
+    pointer operator->() const noexcept {
+        return ptr_;
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    Iterator& operator++() noexcept {
+        ++index_;
+        if (++ptr_ == segment_end_) {
+            Locate();
+        }
+        return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+        Iterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    Iterator& operator--() noexcept {
+        --index_;
+        Locate();
+        return *this;
+    }
+
+    Iterator operator--(int) noexcept {
+        Iterator old = *this;
+        --*this;
+        return old;
+    }
+
+    Iterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        Locate();
+        return *this;
+    }
+
+    Iterator& operator-=(difference_type n) noexcept {
+        return *this += -n;
+    }
+
+    friend Iterator operator+(Iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator+(difference_type n, Iterator it) noexcept {
+        return it += n;
+    }
+
+    friend Iterator operator-(Iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    // За пределами выделенных сегментов (end() заполненного вектора) указатель пуст
+    void Locate() noexcept {
+        if (index_ >= owner_->Capacity()) {
+            ptr_ = segment_end_ = nullptr;
+            return;
+        }
+        const auto [k, offset] = SegmentedVector::Locate(index_);
+        auto& segment = owner_->segments_[k];
+        ptr_ = segment + offset;
+        segment_end_ = segment + SegmentSize(k);
+    }
+
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+    pointer ptr_ = nullptr;
+    pointer segment_end_ = nullptr;
+};
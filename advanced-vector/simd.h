@@ -0,0 +1,334 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// SIMD-ядра поиска, подсчёта, заполнения и свёрток над массивами арифметических типов.
+// Ядра написаны на векторных расширениях GCC и Clang и собираются под несколько ширин регистров:
+// 16 байт (SSE2, NEON), 32 байта (AVX2) и 64 байта (AVX-512). Ширина выбирается один раз
+// по возможностям процессора. Другие компиляторы используют алгоритмы std
+namespace detail::simd {
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+
+template <typename T>
+inline constexpr bool kSupported = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+                                   || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+#else
+
+template <typename T>
+inline constexpr bool kSupported = false;
+
+#endif
+
+enum class Isa {
+    kBaseline,  // SSE2 или NEON
+    kAvx2,
+    kAvx512,
+};
+
+inline Isa DetectIsa() noexcept {
+#if defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return Isa::kAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::kAvx2;
+    }
+#endif
+    return Isa::kBaseline;
+}
+
+inline Isa ActiveIsa() noexcept {
+    static const Isa isa = DetectIsa();
+    return isa;
+}
+
+#if defined(__GNUC__)
+
+template <typename T, size_t Bytes>
+using Vec [[gnu::vector_size(Bytes)]] = T;
+
+// Векторы передаются по ссылке: передача по значению зависит от набора инструкций вызывающей функции.
+// Начало data выровнено по Align байт, поэтому выровнены и загрузки по кратным ширине смещениям
+template <size_t Align, typename V, typename T>
+[[gnu::always_inline]] inline void Load(V& out, const T* data, size_t offset) noexcept {
+    const T* base = static_cast<const T*>(__builtin_assume_aligned(data, Align));
+    std::memcpy(&out, base + offset, sizeof(V));
+}
+
+template <typename M>
+[[gnu::always_inline]] inline bool AnyTrue(const M& mask) noexcept {
+    Vec<uint64_t, sizeof(M)> bits;
+    std::memcpy(&bits, &mask, sizeof(M));
+    uint64_t any = 0;
+    for (size_t lane = 0; lane < sizeof(M) / sizeof(uint64_t); ++lane) {
+        any |= bits[lane];
+    }
+    return any != 0;
+}
+
+template <typename T, size_t Align>
+struct FindKernel {
+    template <size_t Bytes>
+    [[gnu::always_inline]] static size_t Run(const T* data, size_t n, T value) noexcept {
+        using V = Vec<T, Bytes>;
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;  // длина части из целых регистров
+        const V needle = V{} + value;
+        size_t i = 0;
+        for (; i < full; i += kLanes) {
+            V chunk;
+            Load<Align>(chunk, data, i);
+            if (AnyTrue(chunk == needle)) {
+                break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+};
+
+template <typename T, size_t Align>
+struct CountKernel {
+    template <size_t Bytes>
+    [[gnu::always_inline]] static size_t Run(const T* data, size_t n, T value) noexcept {
+        using V = Vec<T, Bytes>;
+        using M = decltype(V{} == V{});
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;
+        // Дорожки маски вычитают по единице за совпадение; узкие дорожки сбрасываются в total до переполнения
+        constexpr size_t kMaxSteps = sizeof(T) >= 4 ? size_t{1} << 30 : (size_t{1} << (8 * sizeof(T) - 1)) - 1;
+        const V needle = V{} + value;
+        size_t total = 0;
+        size_t i = 0;
+        while (i < full) {
+            const size_t steps = std::min((full - i) / kLanes, kMaxSteps);
+            M counts{};
+            for (size_t step = 0; step < steps; ++step, i += kLanes) {
+                V chunk;
+                Load<Align>(chunk, data, i);
+                counts -= chunk == needle;
+            }
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                total += static_cast<size_t>(counts[lane]);
+            }
+        }
+        for (; i < n; ++i) {
+            total += data[i] == value;
+        }
+        return total;
+    }
+};
+
+template <typename T, size_t Align>
+struct FillKernel {
+    template <size_t Bytes>
+    [[gnu::always_inline]] static void Run(T* data, size_t n, T value) noexcept {
+        using V = Vec<T, Bytes>;
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;
+        T* base = static_cast<T*>(__builtin_assume_aligned(data, Align));
+        const V fill = V{} + value;
+        size_t i = 0;
+        for (; i < full; i += kLanes) {
+            std::memcpy(base + i, &fill, Bytes);
+        }
+        for (; i < n; ++i) {
+            base[i] = value;
+        }
+    }
+};
+
+// Сравнение через !=, как и std::equal: NaN не равен ничему, -0.0 равен 0.0
+template <typename T, size_t Align>
+struct EqualKernel {
+    template <size_t Bytes>
+    [[gnu::always_inline]] static bool Run(const T* lhs, const T* rhs, size_t n) noexcept {
+        using V = Vec<T, Bytes>;
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;
+        size_t i = 0;
+        for (; i < full; i += kLanes) {
+            V a;
+            V b;
+            Load<Align>(a, lhs, i);
+            Load<Align>(b, rhs, i);
+            if (AnyTrue(a != b)) {
+                return false;
+            }
+        }
+        for (; i < n; ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Массив не пуст. При наличии NaN результат не определён
+template <typename T, size_t Align>
+struct MinMaxKernel {
+    template <size_t Bytes>
+    [[gnu::always_inline]] static std::pair<T, T> Run(const T* data, size_t n) noexcept {
+        using V = Vec<T, Bytes>;
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;
+        T min = data[0];
+        T max = data[0];
+        size_t i = 0;
+        if (full > 0) {
+            V vmin;
+            Load<Align>(vmin, data, 0);
+            V vmax = vmin;
+            for (i = kLanes; i < full; i += kLanes) {
+                V chunk;
+                Load<Align>(chunk, data, i);
+                vmin = chunk < vmin ? chunk : vmin;
+                vmax = vmax < chunk ? chunk : vmax;
+            }
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                min = vmin[lane] < min ? vmin[lane] : min;
+                max = max < vmax[lane] ? vmax[lane] : max;
+            }
+        }
+        for (; i < n; ++i) {
+            min = data[i] < min ? data[i] : min;
+            max = max < data[i] ? data[i] : max;
+        }
+        return {min, max};
+    }
+};
+
+// Целые суммируются по модулю 2^N, как при std::accumulate с начальным значением T{}.
+// Вещественные суммируются в другом порядке, поэтому результат может отличаться в младших разрядах
+template <typename T, size_t Align>
+struct SumKernel {
+    using Acc = std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::type_identity<T>>::type;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static T Run(const T* data, size_t n) noexcept {
+        using V = Vec<Acc, Bytes>;
+        constexpr size_t kLanes = Bytes / sizeof(T);
+        const size_t full = n - n % kLanes;
+        V acc{};
+        size_t i = 0;
+        for (; i < full; i += kLanes) {
+            V chunk;
+            Load<Align>(chunk, data, i);
+            acc += chunk;
+        }
+        Acc total{};
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            total += acc[lane];
+        }
+        for (; i < n; ++i) {
+            total += static_cast<Acc>(data[i]);
+        }
+        return static_cast<T>(total);
+    }
+};
+
+#if defined(__x86_64__)
+
+template <typename Kernel, typename... Args>
+[[gnu::target("avx2")]] auto RunAvx2(Args... args) noexcept {
+    return Kernel::template Run<32>(args...);
+}
+
+template <typename Kernel, typename... Args>
+[[gnu::target("avx512f,avx512bw")]] auto RunAvx512(Args... args) noexcept {
+    return Kernel::template Run<64>(args...);
+}
+
+#endif
+
+// Выполняет ядро с шириной регистров набора isa, который должен поддерживаться процессором
+template <typename Kernel, typename... Args>
+auto Run(Isa isa, Args... args) noexcept {
+#if defined(__x86_64__)
+    switch (isa) {
+        case Isa::kAvx512:
+            return RunAvx512<Kernel>(args...);
+        case Isa::kAvx2:
+            return RunAvx2<Kernel>(args...);
+        case Isa::kBaseline:
+            break;
+    }
+#endif
+    return Kernel::template Run<16>(args...);
+}
+
+#endif
+
+// Алгоритмы над data[0, n). Align — гарантированное выравнивание data
+template <size_t Align, typename T>
+size_t Find(const T* data, size_t n, T value) noexcept {
+#if defined(__GNUC__)
+    return Run<FindKernel<T, Align>>(ActiveIsa(), data, n, value);
+#else
+    return std::find(data, data + n, value) - data;
+#endif
+}
+
+template <size_t Align, typename T>
+size_t Count(const T* data, size_t n, T value) noexcept {
+#if defined(__GNUC__)
+    return Run<CountKernel<T, Align>>(ActiveIsa(), data, n, value);
+#else
+    return std::count(data, data + n, value);
+#endif
+}
+
+template <size_t Align, typename T>
+void Fill(T* data, size_t n, T value) noexcept {
+#if defined(__GNUC__)
+    Run<FillKernel<T, Align>>(ActiveIsa(), data, n, value);
+#else
+    std::fill_n(data, n, value);
+#endif
+}
+
+template <size_t Align, typename T>
+bool Equal(const T* lhs, const T* rhs, size_t n) noexcept {
+#if defined(__GNUC__)
+    return Run<EqualKernel<T, Align>>(ActiveIsa(), lhs, rhs, n);
+#else
+    return std::equal(lhs, lhs + n, rhs);
+#endif
+}
+
+template <size_t Align, typename T>
+std::pair<T, T> MinMax(const T* data, size_t n) noexcept {
+#if defined(__GNUC__)
+    return Run<MinMaxKernel<T, Align>>(ActiveIsa(), data, n);
+#else
+    const auto [min, max] = std::minmax_element(data, data + n);
+    return {*min, *max};
+#endif
+}
+
+template <size_t Align, typename T>
+T Sum(const T* data, size_t n) noexcept {
+#if defined(__GNUC__)
+    return Run<SumKernel<T, Align>>(ActiveIsa(), data, n);
+#else
+    T total{};
+    for (size_t i = 0; i < n; ++i) {
+        total += data[i];
+    }
+    return total;
+#endif
+}
+
+}  // namespace detail::simd
@@ -0,0 +1,289 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Вектор записей, поля которых хранятся по столбцам: отдельный RawMemory на каждое поле.
+// Обход одного поля читает только его столбец и не тянет в кеш остальные поля записей.
+// Размер и вместимость у столбцов общие, решение о росте принимается одно на все столбцы.
+// Если создание или перенос поля бросает исключение, столбцы остаются согласованными:
+// размер не меняется, а столбцы, перенос которых требует копирования, сохраняют содержимое.
+// Политика роста идёт первым параметром: за пакетом полей параметр по умолчанию не поставить,
+// поэтому SoaVector<Fields...> — псевдоним с DoublingGrowth
+template <typename Growth, typename... Fields>
+class BasicSoaVector {
+    static_assert(sizeof...(Fields) > 0);
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+public:
+    using Reference = std::tuple<Fields&...>;
+    using ConstReference = std::tuple<const Fields&...>;
+
+    BasicSoaVector() = default;
+
+    // Поля size записей инициализируются значением
+    explicit BasicSoaVector(size_t size)
+        : columns_(RawMemory<Fields>(size)...) {
+        ForEachFieldOrUndo(
+            [this, size](auto i) {
+                std::uninitialized_value_construct_n(Data<i>(columns_), size);
+            },
+            [this, size](auto i) {
+                std::destroy_n(Data<i>(columns_), size);
+            });
+        size_ = size;
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : columns_(RawMemory<Fields>(other.size_)...) {
+        ForEachFieldOrUndo(
+            [this, &other](auto i) {
+                std::uninitialized_copy_n(Data<i>(other.columns_), other.size_, Data<i>(columns_));
+            },
+            [this, &other](auto i) {
+                std::destroy_n(Data<i>(columns_), other.size_);
+            });
+        size_ = other.size_;
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs) {
+        if (this != &rhs) {
+            BasicSoaVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BasicSoaVector old(std::move(*this));
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~BasicSoaVector() {
+        DestroyTail(0);
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            Columns new_columns{RawMemory<Fields>(new_capacity)...};
+            RelocateColumns(new_columns);
+            columns_.swap(new_columns);
+        }
+    }
+
+    // Новые записи инициализируются значением
+    void Resize(size_t new_size) {
+        if (new_size <= size_) {
+            DestroyTail(new_size);
+            size_ = new_size;
+            return;
+        }
+        if (new_size > Capacity()) {
+            Reserve(NextCapacity(new_size));
+        }
+        ForEachFieldOrUndo(
+            [this, new_size](auto i) {
+                std::uninitialized_value_construct(Data<i>(columns_) + size_, Data<i>(columns_) + new_size);
+            },
+            [this, new_size](auto i) {
+                std::destroy(Data<i>(columns_) + size_, Data<i>(columns_) + new_size);
+            });
+        size_ = new_size;
+    }
+
+    // Принимает значения всех полей записи. Аргументы могут ссылаться на элементы вектора:
+    // при росте новая запись создаётся до переноса прежних
+    template <typename... Types>
+    Reference EmplaceBack(Types&&... values) {
+        static_assert(sizeof...(Types) == sizeof...(Fields), "нужно значение для каждого поля");
+        auto args = std::forward_as_tuple(std::forward<Types>(values)...);
+        if (size_ == Capacity()) {
+            Columns new_columns{RawMemory<Fields>(NextCapacity(size_ + 1))...};
+            ConstructRecord(new_columns, std::move(args));
+            try {
+                RelocateColumns(new_columns);
+            } catch (...) {
+                ForEachField([this, &new_columns](auto i) {
+                    std::destroy_at(Data<i>(new_columns) + size_);
+                });
+                throw;
+            }
+            columns_.swap(new_columns);
+        } else {
+            ConstructRecord(columns_, std::move(args));
+        }
+        return (*this)[size_++];
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        DestroyTail(size_ - 1);
+        --size_;
+    }
+
+    // Сдвигает последующие записи на место удалённой. Каждый столбец сдвигается так же, как у Vector:
+    // тривиально перемещаемые поля переносятся одним memmove
+    void Erase(size_t index) noexcept((std::is_nothrow_move_assignable_v<Fields> && ...)) {
+        assert(index < size_);
+        ForEachField([this, index](auto i) {
+            size_t size = size_;
+            Field<i>* data = Data<i>(columns_);
+            detail::EraseInPlace(data, size, data + index, data + index + 1);
+        });
+        --size_;
+    }
+
+    void Clear() noexcept {
+        DestroyTail(0);
+        size_ = 0;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    // Столбец поля с номером I
+    template <size_t I>
+    std::span<Field<I>> Column() noexcept {
+        return {Data<I>(columns_), size_};
+    }
+
+    template <size_t I>
+    std::span<const Field<I>> Column() const noexcept {
+        return {Data<I>(columns_), size_};
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return std::apply(
+            [index](auto&... columns) {
+                return Reference(columns[index]...);
+            },
+            columns_);
+    }
+
+    ConstReference operator[](size_t index) const noexcept {
+        return const_cast<BasicSoaVector&>(*this)[index];
+    }
+
+    void Swap(BasicSoaVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+    template <size_t I>
+    static Field<I>* Data(Columns& columns) noexcept {
+        return std::get<I>(columns).GetAddress();
+    }
+
+    template <size_t I>
+    static const Field<I>* Data(const Columns& columns) noexcept {
+        return std::get<I>(columns).GetAddress();
+    }
+
+    // Политика роста получает размер записи целиком
+    size_t NextCapacity(size_t required) const noexcept {
+        return Growth::NextCapacity(Capacity(), required, (sizeof(Fields) + ...));
+    }
+
+    // Вызывает f(std::integral_constant<size_t, I>{}) для номеров полей по порядку
+    template <typename F>
+    static void ForEachField(F&& f) {
+        [&f]<size_t... I>(std::index_sequence<I...>) {
+            (f(std::integral_constant<size_t, I>{}), ...);
+        }(std::index_sequence_for<Fields...>{});
+    }
+
+    // Вызывает op для полей по порядку. Если op бросит исключение, для полей,
+    // обработанных до этого, вызывается undo, и исключение пробрасывается дальше
+    template <typename Op, typename Undo>
+    static void ForEachFieldOrUndo(Op&& op, Undo&& undo) {
+        size_t done = 0;
+        try {
+            ForEachField([&op, &done](auto i) {
+                op(i);
+                ++done;
+            });
+        } catch (...) {
+            ForEachField([&undo, done](auto i) {
+                if (i < done) {
+                    undo(i);
+                }
+            });
+            throw;
+        }
+    }
+
+    // Создаёт поля записи с номером size_ в столбцах columns
+    template <typename Args>
+    void ConstructRecord(Columns& columns, Args&& args) {
+        ForEachFieldOrUndo(
+            [this, &columns, &args](auto i) {
+                new (Data<i>(columns) + size_) Field<i>(std::get<i>(std::move(args)));
+            },
+            [this, &columns](auto i) {
+                std::destroy_at(Data<i>(columns) + size_);
+            });
+    }
+
+    // Переносит записи в new_columns. Сначала копируются столбцы, перенос которых может бросить
+    // исключение: при ошибке копии уничтожаются, а исходные столбцы не меняются. Затем остальные
+    // столбцы переносятся без исключений, и исходные элементы скопированных уничтожаются
+    void RelocateColumns(Columns& new_columns) {
+        ForEachFieldOrUndo(
+            [this, &new_columns](auto i) {
+                if constexpr (!detail::kNothrowRelocate<Field<i>>) {
+                    detail::UninitializedCopyOrMove(Data<i>(columns_), size_, Data<i>(new_columns));
+                }
+            },
+            [this, &new_columns](auto i) {
+                if constexpr (!detail::kNothrowRelocate<Field<i>>) {
+                    std::destroy_n(Data<i>(new_columns), size_);
+                }
+            });
+        ForEachField([this, &new_columns](auto i) {
+            if constexpr (detail::kNothrowRelocate<Field<i>>) {
+                detail::UninitializedRelocate(Data<i>(columns_), size_, Data<i>(new_columns));
+            } else {
+                std::destroy_n(Data<i>(columns_), size_);
+            }
+        });
+    }
+
+    // Уничтожает записи с номерами от first до size_
+    void DestroyTail(size_t first) noexcept {
+        ForEachField([this, first](auto i) {
+            std::destroy(Data<i>(columns_) + first, Data<i>(columns_) + size_);
+        });
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
+
+template <typename... Fields>
+using SoaVector = BasicSoaVector<DoublingGrowth, Fields...>;
@@ -1,319 +1,1945 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <new>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <type_traits>
-#include <utility>
+
+#include "simd.h"
+#include "vector_stats.h"
+
+// Тип тривиально перемещаем, если объект можно перенести в другое место памяти
+// побайтовым копированием, не вызывая деструктор исходного объекта.
+// Для собственных типов (например, владеющих std::unique_ptr) допускается специализация
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {
+};
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {
+};
 
 template <typename T>
+struct is_trivially_relocatable<std::allocator<T>> : std::true_type {
+};
+
+template <typename T>
+struct is_trivially_relocatable<std::pmr::polymorphic_allocator<T>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <typename T, typename Alloc = std::allocator<T>>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>);
+
 public:
-    RawMemory() = default;
+    using allocator_type = Alloc;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    // Все элементы всегда хранятся в динамической памяти
+    static constexpr bool kHasInlineStorage = false;
+    static constexpr size_t kInlineCapacity = 0;
+
+    constexpr RawMemory() = default;
+
+    constexpr explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    constexpr explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc)
+        , buffer_(Allocate(capacity))
+        , capacity_(capacity) {
+    }
+
+    // Принимает во владение буфер на capacity элементов, выделенный аллокатором alloc
+    constexpr RawMemory(T* buffer, size_t capacity, const Alloc& alloc) noexcept
+        : alloc_(alloc)
+        , buffer_(buffer)
         , capacity_(capacity) {
     }
 
     RawMemory(const RawMemory& other) = delete;
     RawMemory& operator=(const RawMemory& other) = delete;
 
-    RawMemory(RawMemory&& rhs) noexcept
-        : buffer_(rhs.buffer_)
+    constexpr RawMemory(RawMemory&& rhs) noexcept
+        : alloc_(std::move(rhs.alloc_))
+        , buffer_(rhs.buffer_)
         , capacity_(rhs.capacity_) {
         rhs.buffer_ = nullptr;
         rhs.capacity_ = 0;
     }
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
             this->Swap(rhs);
         }
         return *this;
     }
 
-    ~RawMemory() {
+    constexpr ~RawMemory() {
         if (buffer_) {
-            Deallocate(buffer_);
+            Deallocate(buffer_, capacity_);
         }
     }
 
-    T* operator+(size_t offset) noexcept {
+    constexpr T* operator+(size_t offset) noexcept {
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    constexpr const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    constexpr T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    // Буфер всегда обменивается вместе с аллокатором, который его выделил.
+    // Аллокаторы без операции обмена (например, std::pmr::polymorphic_allocator)
+    // допускают обмен только между равными аллокаторами
+    constexpr void Swap(RawMemory& other) noexcept {
+        if constexpr (std::is_swappable_v<Alloc>) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    constexpr Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Аллокатор умеет изменять размер блока, по возможности не перенося его (realloc, mremap)
+    static constexpr bool kCanReallocate = requires(Alloc& alloc, T* buf, size_t n) {
+        { alloc.reallocate(buf, n, n) } -> std::same_as<T*>;
+    };
+
+    // Изменяет вместимость, сохраняя содержимое буфера. Данные переносятся побайтово,
+    // поэтому метод подходит только для тривиально перемещаемых элементов.
+    // При исключении буфер остаётся прежним
+    void Reallocate(size_t new_capacity) requires kCanReallocate {
+        if (new_capacity == 0) {
+            RawMemory empty(alloc_);
+            Swap(empty);
+            return;
+        }
+        buffer_ = buffer_ ? alloc_.reallocate(buffer_, capacity_, new_capacity) : Allocate(new_capacity);
+        capacity_ = new_capacity;
+    }
+
+    constexpr const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    constexpr T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    constexpr size_t Capacity() const {
         return capacity_;
     }
 
+    // Отказывается от владения буфером. Освободить его можно, вновь передав RawMemory
+    constexpr T* Release() noexcept {
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    constexpr T* Allocate(size_t n) {
+        return n != 0 ? AllocTraits::allocate(alloc_, n) : nullptr;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    constexpr void Deallocate(T* buf, size_t n) noexcept {
+        AllocTraits::deallocate(alloc_, buf, n);
     }
 
+    [[no_unique_address]] Alloc alloc_;
     T* buffer_ = nullptr;
     size_t capacity_ = 0;
 }; 
 
+// Политики роста выбирают новую вместимость, когда текущей capacity не хватает
+// для required элементов размера elem_size. Результат не меньше required
+
+// Удвоение вместимости, начиная с одного элемента
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*elem_size*/) noexcept {
+        return std::max(required, capacity == 0 ? size_t{1} : capacity * 2);
+    }
+};
+
+// Рост в полтора раза: сумма освобождённых ранее блоков со временем превышает
+// очередной запрос, и аллокатор может переиспользовать эту память
+struct OneAndHalfGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*elem_size*/) noexcept {
+        return std::max(required, capacity + std::max(capacity / 2, size_t{1}));
+    }
+};
+
+// Вместимость не меньше MinBytes байт (по умолчанию — кеш-линия), чтобы не
+// перевыделять память на первых вставках
+template <typename Base = DoublingGrowth, size_t MinBytes = 64>
+struct CacheLineGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) noexcept {
+        const size_t min_capacity = std::max(MinBytes / elem_size, size_t{1});
+        return std::max(Base::NextCapacity(capacity, required, elem_size), min_capacity);
+    }
+};
+
+// Округляет размер блока вверх до границы, которую аллокатор всё равно выделит:
+// мелкие блоки — до шага размеров malloc, блоки от страницы — до целых страниц
+template <typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct SizeClassGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) noexcept {
+        const size_t bytes = Base::NextCapacity(capacity, required, elem_size) * elem_size;
+        const size_t granularity = bytes >= PageSize ? PageSize : alignof(std::max_align_t);
+        return (bytes + granularity - 1) / granularity * granularity / elem_size;
+    }
+};
+
+// Политика может также уменьшать вместимость: ShrinkCapacity(capacity, size, elem_size)
+// возвращает вместимость, которую следует оставить вектору после удаления элементов
+
+// Рост по Base. Когда элементов становится меньше четверти вместимости, она уменьшается
+// вдвое (пока условие выполняется), но не ниже MinCapacity. Между порогами уменьшения
+// и роста остаётся зазор, поэтому чередование вставок и удалений у границы
+// не приводит к постоянным перевыделениям
+template <typename Base = DoublingGrowth, size_t MinCapacity = 16>
+struct AutoShrinkGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) noexcept {
+        return Base::NextCapacity(capacity, required, elem_size);
+    }
+
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size, size_t /*elem_size*/) noexcept {
+        while (capacity / 2 >= MinCapacity && size < capacity / 4) {
+            capacity /= 2;
+        }
+        return capacity;
+    }
+};
+
+template <typename T, typename Alloc>
+struct is_trivially_relocatable<RawMemory<T, Alloc>> : is_trivially_relocatable<Alloc> {
+};
+
+// Хранилище с местом под N элементов внутри самого объекта. Динамический буфер
+// выделяется, только когда элементы перестают помещаться во встроенный.
+// Элементы встроенного буфера переносит владелец хранилища: лишь ему известно их число
+template <typename T, size_t N, typename Alloc = std::allocator<T>>
+class SmallStorage {
+    static_assert(N > 0);
+
+public:
+    using allocator_type = Alloc;
+
+    static constexpr bool kHasInlineStorage = true;
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallStorage() = default;
+
+    explicit SmallStorage(const Alloc& alloc) noexcept
+        : heap_(alloc) {
+    }
+
+    explicit SmallStorage(size_t capacity, const Alloc& alloc = Alloc())
+        : heap_(capacity > N ? capacity : 0, alloc) {
+    }
+
+    SmallStorage(const SmallStorage& other) = delete;
+    SmallStorage& operator=(const SmallStorage& other) = delete;
+
+    // Забирает только динамический буфер other, если он есть
+    SmallStorage(SmallStorage&& other) noexcept
+        : heap_(std::move(other.heap_)) {
+    }
+
+    T* operator+(size_t offset) noexcept {
+        assert(offset <= Capacity());
+        return GetAddress() + offset;
+    }
+
+    const T* operator+(size_t offset) const noexcept {
+        return const_cast<SmallStorage&>(*this) + offset;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallStorage&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Capacity());
+        return GetAddress()[index];
+    }
+
+    // Делает текущим буфер other, а прежний динамический буфер отдаёт other.
+    // Пустой other возвращает хранилище к встроенному буферу
+    void Swap(RawMemory<T, Alloc>& other) noexcept {
+        heap_.Swap(other);
+    }
+
+    // Обменивает динамические буферы
+    void Swap(SmallStorage& other) noexcept {
+        heap_.Swap(other.heap_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T* GetAddress() const noexcept {
+        return const_cast<SmallStorage&>(*this).GetAddress();
+    }
+
+    T* GetAddress() noexcept {
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_)) : heap_.GetAddress();
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+private:
+    RawMemory<T, Alloc> heap_;
+    alignas(T) std::byte inline_[sizeof(T) * N];
+};
+
+// Встроенные элементы переносятся вместе с объектом, указателей на себя хранилище не держит
+template <typename T, size_t N, typename Alloc>
+struct is_trivially_relocatable<SmallStorage<T, N, Alloc>>
+    : std::conjunction<is_trivially_relocatable<T>, is_trivially_relocatable<Alloc>> {
+};
+
+// Разрешает параллельные перегрузки массовых операций Vector для политики выполнения.
+// Стандартные политики подключает vector_execution.h: vector.h не зависит от <execution>,
+// который в libstdc++ требует компоновки с TBB
+template <typename Policy>
+struct is_parallel_policy : std::false_type {
+};
+
+template <typename Policy>
+inline constexpr bool is_parallel_policy_v = is_parallel_policy<std::remove_cvref_t<Policy>>::value;
+
+namespace detail {
+
+// Меньшие части обрабатываются быстрее, чем запускается поток
+inline constexpr size_t kMinParallelChunk = size_t{1} << 14;
+inline constexpr size_t kMaxParallelChunks = 256;
+
+inline size_t ParallelChunkCount(size_t n) noexcept {
+    const size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+    return std::clamp<size_t>(n / kMinParallelChunk, 1, threads);
+}
+
+// Делит [0, n) на chunks частей и вызывает op(first, last) для каждой в своём потоке.
+// op должна либо обработать часть целиком, либо откатить её и бросить исключение.
+// Если хотя бы одна часть завершилась исключением, для всех успешных вызывается
+// undo(first, last), и первое исключение пробрасывается дальше
+template <typename Op, typename Undo>
+void ForEachChunk(size_t n, size_t chunks, Op op, Undo undo) {
+    chunks = std::min(chunks, kMaxParallelChunks);
+    if (chunks <= 1 || n < chunks) {
+        op(size_t{0}, n);
+        return;
+    }
+    auto bound = [n, chunks](size_t i) {
+        return n / chunks * i + std::min(i, n % chunks);
+    };
+    std::unique_ptr<std::exception_ptr[]> errors;
+    std::unique_ptr<std::jthread[]> threads;
+    try {
+        errors = std::make_unique<std::exception_ptr[]>(chunks);
+        threads = std::make_unique<std::jthread[]>(chunks - 1);
+    } catch (const std::bad_alloc&) {
+        op(size_t{0}, n);
+        return;
+    }
+    auto run = [&](size_t i) {
+        try {
+            op(bound(i), bound(i + 1));
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    for (size_t i = 1; i < chunks; ++i) {
+        try {
+            threads[i - 1] = std::jthread(run, i);
+        } catch (const std::system_error&) {
+            // Поток не удалось запустить: часть выполняется в текущем
+            run(i);
+        }
+    }
+    run(0);
+    threads.reset();
+
+    std::exception_ptr error;
+    for (size_t i = 0; i < chunks; ++i) {
+        if (errors[i] && !error) {
+            error = errors[i];
+        }
+    }
+    if (error) {
+        for (size_t i = 0; i < chunks; ++i) {
+            if (!errors[i]) {
+                undo(bound(i), bound(i + 1));
+            }
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename Op, typename Undo>
+void ForEachChunk(size_t n, Op op, Undo undo) {
+    ForEachChunk(n, ParallelChunkCount(n), std::move(op), std::move(undo));
+}
+
+// Элементы переносятся перемещением, если оно не бросает исключений или копирование невозможно
+template <typename T>
+inline constexpr bool kMoveOnRelocate = std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>;
+
+// Перенос в новый буфер не бросает исключений и не портит исходные элементы при ошибке
+template <typename T>
+inline constexpr bool kNothrowRelocate = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+// Создаёт n элементов в неинициализированной памяти to вызовами construct(to + i) по порядку.
+// Если очередной вызов бросит исключение, созданные элементы уничтожаются
+template <typename T, typename F>
+constexpr void ConstructEach(T* to, size_t n, F&& construct) {
+    size_t i = 0;
+    try {
+        for (; i < n; ++i) {
+            construct(to + i);
+        }
+    } catch (...) {
+        std::destroy_n(to, i);
+        throw;
+    }
+}
+
+// Аналоги std::uninitialized_*_n, применимые в константных выражениях: во время компиляции
+// элементы создаются по одному через std::construct_at, во время выполнения вызываются алгоритмы std.
+// При вычислении во время компиляции инициализация по умолчанию заменяется инициализацией значением
+template <typename T>
+constexpr void UninitializedValueConstructN(T* to, size_t n) {
+    if (std::is_constant_evaluated()) {
+        ConstructEach(to, n, [](T* p) {
+            std::construct_at(p);
+        });
+    } else {
+        std::uninitialized_value_construct_n(to, n);
+    }
+}
+
+template <typename T>
+constexpr void UninitializedDefaultConstructN(T* to, size_t n) {
+    if (std::is_constant_evaluated()) {
+        UninitializedValueConstructN(to, n);
+    } else {
+        std::uninitialized_default_construct_n(to, n);
+    }
+}
+
+template <typename InputIt, typename T>
+constexpr void UninitializedCopyN(InputIt first, size_t n, T* to) {
+    if (std::is_constant_evaluated()) {
+        ConstructEach(to, n, [&first](T* p) {
+            std::construct_at(p, *first);
+            ++first;
+        });
+    } else {
+        std::uninitialized_copy_n(first, n, to);
+    }
+}
+
+template <typename T>
+constexpr void UninitializedMoveN(T* from, size_t n, T* to) {
+    if (std::is_constant_evaluated()) {
+        ConstructEach(to, n, [&from](T* p) {
+            std::construct_at(p, std::move(*from++));
+        });
+    } else {
+        std::uninitialized_move_n(from, n, to);
+    }
+}
+
+template <typename T>
+constexpr void UninitializedCopyOrMove(T* from, size_t size, T* to) {
+    if constexpr (kMoveOnRelocate<T>) {
+        UninitializedMoveN(from, size, to);
+    } else {
+        UninitializedCopyN(from, size, to);
+    }
+}
+
+// Переносит size элементов в неинициализированную память to, завершая время жизни исходных.
+// Тривиально перемещаемые элементы переносятся одним memcpy без вызова деструкторов
+template <typename T>
+constexpr void UninitializedRelocate(T* from, size_t size, T* to) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            // У пустого вектора может не быть буфера, а memcpy нельзя передавать nullptr
+            if (size != 0 && from != nullptr) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), size * sizeof(T));
+            }
+            return;
+        }
+    }
+    UninitializedCopyOrMove(from, size, to);
+    std::destroy_n(from, size);
+}
+
+// Как UninitializedRelocate, но диапазоны [from, from + size) и [to, to + size) могут перекрываться
+template <typename T>
+constexpr void RelocateOverlapping(T* from, size_t size, T* to) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            if (size != 0 && from != nullptr) {
+                std::memmove(static_cast<void*>(to), static_cast<const void*>(from), size * sizeof(T));
+            }
+            return;
+        }
+    }
+    if (to < from) {
+        for (size_t i = 0; i < size; ++i) {
+            std::construct_at(to + i, std::move(from[i]));
+            std::destroy_at(from + i);
+        }
+    } else {
+        for (size_t i = size; i > 0; --i) {
+            std::construct_at(to + i - 1, std::move(from[i - 1]));
+            std::destroy_at(from + i - 1);
+        }
+    }
+}
+
+// Сдвиги элементов внутри буфера data с size элементами, общие для Vector и InplaceVector.
+// Вызывающий гарантирует, что в буфере хватает места для новых элементов; size обновляется
+// по мере создания элементов, поэтому при исключении остаётся равным числу живых элементов
+
+// Создаёт элемент перед pos, сдвигая хвост на одну позицию. Тривиально перемещаемый хвост
+// сдвигается одним memmove. Аргументы могут ссылаться на сдвигаемые элементы, поэтому новый
+// элемент создаётся до сдвига во временной памяти и переносится на место побайтово
+template <typename T, typename... Types>
+constexpr void EmplaceInPlace(T* data, size_t& size, T* pos, Types&&... values) {
+    T* old_end = data + size;
+    if (pos == old_end) {
+        std::construct_at(pos, std::forward<Types>(values)...);
+        ++size;
+        return;
+    }
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!std::is_constant_evaluated()) {
+            alignas(T) std::byte slot[sizeof(T)];
+            T* tmp = std::construct_at(reinterpret_cast<T*>(slot), std::forward<Types>(values)...);
+            RelocateOverlapping(pos, old_end - pos, pos + 1);
+            std::memcpy(static_cast<void*>(pos), static_cast<const void*>(tmp), sizeof(T));
+            ++size;
+            return;
+        }
+    }
+    T tmp(std::forward<Types>(values)...);
+    std::construct_at(old_end, std::move(*(old_end - 1)));
+    ++size;
+    std::move_backward(pos, old_end - 1, old_end);
+    *pos = std::move(tmp);
+}
+
+// Удаляет элементы [first, last), сдвигая хвост за один проход
 template <typename T>
+constexpr void EraseInPlace(T* data, size_t& size, T* first, T* last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    const size_t count = last - first;
+    T* old_end = data + size;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        std::destroy(first, last);
+        RelocateOverlapping(last, old_end - last, first);
+    } else {
+        std::move(last, old_end, first);
+        std::destroy_n(old_end - count, count);
+    }
+    size -= count;
+}
+
+// Вставляет count элементов, начиная с first, на позицию index
+template <typename T, typename ForwardIt>
+constexpr void InsertInPlace(T* data, size_t& size, size_t index, ForwardIt first, size_t count) {
+    T* pos = data + index;
+    T* old_end = data + size;
+    const size_t after = size - index;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        RelocateOverlapping(pos, after, pos + count);
+        try {
+            UninitializedCopyN(first, count, pos);
+        } catch (...) {
+            RelocateOverlapping(pos + count, after, pos);
+            throw;
+        }
+        size += count;
+    } else if (after > count) {
+        UninitializedMoveN(old_end - count, count, old_end);
+        size += count;
+        std::move_backward(pos, old_end - count, old_end);
+        std::copy_n(first, count, pos);
+    } else {
+        ForwardIt mid = std::next(first, after);
+        UninitializedCopyN(mid, count - after, old_end);
+        size += count - after;
+        UninitializedMoveN(pos, after, pos + count);
+        size += after;
+        std::copy(first, mid, pos);
+    }
+}
+
+[[noreturn]] inline void Trap() noexcept {
+#if defined(__GNUC__)
+    __builtin_trap();
+#else
+    std::abort();
+#endif
+}
+
+// Номер поколения буфера вектора: увеличивается при каждой смене буфера
+struct BufferGeneration {
+    constexpr void Bump() noexcept {
+        ++value;
+    }
+
+    size_t value = 0;
+};
+
+struct NoBufferGeneration {
+    constexpr void Bump() noexcept {
+    }
+};
+
+}  // namespace detail
+
+// Политики проверки предусловий: индексов operator[], позиций Insert/Emplace/Erase и т.п.
+// NoChecks полагается на assert, который отключается в сборках с NDEBUG.
+// BoundsChecks проверяет всегда и при нарушении аварийно останавливает программу одной инструкцией.
+// DebugChecks дополнительно выдаёт итераторы, помнящие поколение буфера: итератор, полученный
+// до перевыделения памяти, обмена или перемещения вектора, обнаруживается при разыменовании
+// или передаче в Insert/Erase. Нарушение сообщается в stderr, затем вызывается std::abort
+struct NoChecks {
+    static constexpr bool kBounds = false;
+    static constexpr bool kIterators = false;
+};
+
+struct BoundsChecks {
+    static constexpr bool kBounds = true;
+    static constexpr bool kIterators = false;
+
+    [[noreturn]] static void Fail(const char* /*what*/) noexcept {
+        detail::Trap();
+    }
+};
+
+struct DebugChecks {
+    static constexpr bool kBounds = true;
+    static constexpr bool kIterators = true;
+
+    [[noreturn]] static void Fail(const char* what) noexcept {
+        std::fprintf(stderr, "Vector: %s\n", what);
+        std::abort();
+    }
+};
+
+// Сборка с ADVANCED_VECTOR_HARDENED проверяет границы во всех векторах, где политика не указана явно.
+// Макрос должен быть одинаково определён во всех единицах трансляции
+#if defined(ADVANCED_VECTOR_HARDENED)
+using DefaultChecks = BoundsChecks;
+#else
+using DefaultChecks = NoChecks;
+#endif
+
+// Метка конструктора, инициализирующего элементы по умолчанию: элементы
+// тривиальных типов остаются неинициализированными
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag default_init{};
+
+// Политики статистики не хранят указателей на себя
+template <>
+struct is_trivially_relocatable<VectorStats> : std::true_type {
+};
+
+template <>
+struct is_trivially_relocatable<CallSiteStats> : std::true_type {
+};
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          typename Storage = RawMemory<T, Alloc>, typename Stats = NoStats, typename Checking = DefaultChecks>
 class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    // Новые буферы при росте всегда выделяются в динамической памяти
+    using Buffer = RawMemory<T, Alloc>;
+    static_assert(std::is_same_v<typename Storage::allocator_type, Alloc>);
+
+    template <bool Const>
+    class CheckedIterator;
+
 public:
+    using allocator_type = Alloc;
+    using iterator = std::conditional_t<Checking::kIterators, CheckedIterator<false>, T*>;
+    using const_iterator = std::conditional_t<Checking::kIterators, CheckedIterator<true>, const T*>;
 
-    using iterator = T*;
-    using const_iterator = const T*;
-    
-    iterator begin() noexcept {
-        return data_.GetAddress();
+    constexpr iterator begin() noexcept {
+        return MakeIterator(Data());
     }
 
-    iterator end() noexcept {
-        return data_ + size_;
+    constexpr iterator end() noexcept {
+        return MakeIterator(Data() + size_);
     }
 
-    const_iterator begin() const noexcept {
+    constexpr const_iterator begin() const noexcept {
         return const_cast<Vector&>(*this).begin();
     }
 
-    const_iterator end() const noexcept {
+    constexpr const_iterator end() const noexcept {
         return const_cast<Vector&>(*this).end();
     }
 
-    const_iterator cbegin() const noexcept {
+    constexpr const_iterator cbegin() const noexcept {
         return begin();
     }
 
-    const_iterator cend() const noexcept {
+    constexpr const_iterator cend() const noexcept {
         return end();
     }
 
-    explicit Vector() noexcept = default;
+    constexpr explicit Vector() noexcept = default;
+
+    constexpr explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    // Вектор, собирающий статистику в stats (например, CallSiteStats::Here())
+    constexpr explicit Vector(Stats stats, const Alloc& alloc = Alloc()) noexcept
+        : data_(alloc)
+        , stats_(stats) {
+    }
+
+    constexpr explicit Vector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size) {
+        detail::UninitializedValueConstructN(data_.GetAddress(), size);
+        CountAllocation();
+    }
+
+    // Не обнуляет элементы тривиальных типов: буфер предназначен для последующей записи
+    constexpr Vector(size_t size, DefaultInitTag /*tag*/, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size) {
+        detail::UninitializedDefaultConstructN(data_.GetAddress(), size);
+        CountAllocation();
+    }
+
+    // Параллельные варианты конструктора, Reserve, Assign и Clear для очень больших векторов.
+    // Элементы обрабатываются частями в нескольких потоках; если конструктор элемента бросит
+    // исключение, уже созданные части уничтожаются, а вектор остаётся в прежнем состоянии
+    template <typename Policy>
+        requires is_parallel_policy_v<Policy>
+    Vector(Policy&& /*policy*/, size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size) {
+        T* data = data_.GetAddress();
+        detail::ForEachChunk(
+            size,
+            [data](size_t first, size_t last) {
+                std::uninitialized_value_construct(data + first, data + last);
+            },
+            [data](size_t first, size_t last) {
+                std::destroy(data + first, data + last);
+            });
+        CountAllocation();
+    }
 
-    explicit Vector(size_t size) : data_(size), size_(size) {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    constexpr Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
     }
 
-    Vector(const Vector& other) : data_(other.size_), size_(other.size_) {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+    constexpr Vector(const Vector& other, const Alloc& alloc)
+        : Vector(other, alloc, other.stats_) {
     }
 
-    Vector& operator=(const Vector& rhs) {
+    constexpr Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
-            if (rhs.Size() > this->Capacity()) {
-                Vector<T> copy(rhs);
+            if (kPropagateOnCopy && this->GetAllocator() != rhs.GetAllocator()) {
+                // Память, выделенная старым аллокатором, должна им же и освобождаться,
+                // поэтому копия строится сразу с аллокатором rhs
+                Vector copy(rhs, rhs.GetAllocator(), Stats());
+                this->Swap(copy);
+                CountAllocation();
+            } else if (rhs.Size() > this->Capacity()) {
+                Vector copy(rhs, this->GetAllocator(), Stats());
                 this->Swap(copy);
+                CountAllocation();
             } else {
                 CopyWithOldCapacity(rhs);
+                TrackCapacity();
             }
         }
         return *this;
     }
 
-    Vector(Vector &&other) noexcept 
-        : data_(std::move(other.data_)), size_(other.size_)  {
-            other.size_ = 0;
+    constexpr Vector(Vector &&other) noexcept(kNothrowSwap)
+        : data_(std::move(other.data_))
+        , stats_(other.stats_) {
+        if constexpr (Storage::kHasInlineStorage) {
+            if (data_.IsInline()) {
+                RelocateInNewData(other.data_.GetAddress(), other.size_, data_.GetAddress());
+            }
+        }
+        size_ = std::exchange(other.size_, 0);
+        other.generation_.Bump();
+        TrackCapacity();
+        other.TrackCapacity();
     }
 
-    Vector& operator=(Vector&& rhs) noexcept  {
+    constexpr Vector& operator=(Vector&& rhs) noexcept(kNothrowSwap && (kPropagateOnMove || AllocTraits::is_always_equal::value)) {
         if (this != &rhs) {
-            data_.Swap(rhs.data_);
-            std::swap(size_, rhs.size_);
+            if (kPropagateOnMove || this->GetAllocator() == rhs.GetAllocator()) {
+                if constexpr (Storage::kHasInlineStorage) {
+                    Vector tmp(std::move(rhs));
+                    this->Swap(tmp);
+                } else {
+                    data_.Swap(rhs.data_);
+                    std::swap(size_, rhs.size_);
+                    generation_.Bump();
+                    rhs.generation_.Bump();
+                    TrackCapacity();
+                    rhs.TrackCapacity();
+                }
+            } else {
+                MoveWithOwnAllocator(rhs);
+            }
         }
         return *this;
     }
 
-    void Reserve(size_t new_capacity) {
+    constexpr void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        CopyOrMoveInNewData(data_.GetAddress(), size_, new_data.GetAddress());        
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        SetCapacity(new_capacity);
     }
 
-    void Resize(size_t new_size) {
-        if (new_size == size_) {
+    template <typename Policy>
+        requires is_parallel_policy_v<Policy>
+    void Reserve(Policy&& /*policy*/, size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
             return;
         }
-        if (new_size < size_) {
-            std::destroy_n(data_ + new_size, size_ - new_size);
+        if constexpr (kReallocateInPlace) {
+            // Буфер растёт на месте, элементы не переносятся
+            SetCapacity(new_capacity);
+        } else if constexpr (!detail::kNothrowRelocate<T> && kMoveOnRelocate) {
+            // Перенесённые части нельзя вернуть, если перемещение в другой части бросит
+            SetCapacity(new_capacity);
         } else {
-            Reserve(new_size);
-            std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+            Buffer new_data = AllocateBuffer(new_capacity);
+            T* from = data_.GetAddress();
+            T* to = new_data.GetAddress();
+            if constexpr (detail::kNothrowRelocate<T>) {
+                detail::ForEachChunk(
+                    size_,
+                    [from, to](size_t first, size_t last) {
+                        RelocateInNewData(from + first, last - first, to + first);
+                    },
+                    [](size_t, size_t) {
+                    });
+            } else {
+                // Исходные элементы уничтожаются, только когда скопированы все части
+                ParallelUninitializedCopy(from, size_, to);
+                ParallelDestroy(from, size_);
+            }
+            CountRelocation(size_);
+            ReplaceBuffer(new_data);
+            TrackCapacity();
+        }
+    }
+
+    // Уменьшает вместимость до размера. Вектор со встроенным буфером возвращается к нему,
+    // если элементы в нём помещаются
+    constexpr void ShrinkToFit() {
+        if (Capacity() > size_) {
+            SetCapacity(size_);
+        }
+    }
+
+    // Удаляет все элементы. Вместимость сохраняется, если политика роста не уменьшает её
+    constexpr void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+        MaybeShrink();
+    }
+
+    template <typename Policy>
+        requires is_parallel_policy_v<Policy>
+    void Clear(Policy&& /*policy*/) noexcept {
+        ParallelDestroy(data_.GetAddress(), size_);
+        size_ = 0;
+        MaybeShrink();
+    }
+
+    constexpr void Resize(size_t new_size) {
+        if (PrepareResize(new_size)) {
+            detail::UninitializedValueConstructN(data_ + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Как Resize, но новые элементы тривиальных типов остаются неинициализированными
+    constexpr void ResizeDefaultInit(size_t new_size) {
+        if (PrepareResize(new_size)) {
+            detail::UninitializedDefaultConstructN(data_ + size_, new_size - size_);
         }
         size_ = new_size;
     }
 
+    // Пока вместимости хватает, элемент создаётся сразу за последним: общий путь EmplaceAt
+    // со сдвигом хвоста для вставки в конец не нужен
     template <typename... Types>
-    T& EmplaceBack(Types&&... values) {
-        return *Emplace(end(), std::forward<Types>(values)...);
+    constexpr T& EmplaceBack(Types&&... values) {
+        if (size_ == Capacity()) {
+            return *EmplaceAt(Data() + size_, std::forward<Types>(values)...);
+        }
+        T* elem = std::construct_at(Data() + size_, std::forward<Types>(values)...);
+        ++size_;
+        return *elem;
     }
 
-    void PushBack(const T& value) {
+    constexpr void PushBack(const T& value) {
        EmplaceBack(value);
     }
 
-    void PushBack(T&& value) {
+    constexpr void PushBack(T&& value) {
        EmplaceBack(std::move(value));
     }
 
-    void PopBack() noexcept {
+    constexpr void PopBack() noexcept {
         if (size_ == 0) {
             return;
         }
         --size_;
         std::destroy_at(data_ + size_);
+        MaybeShrink();
     }
     
-    iterator Insert(const_iterator cpos, const T& value) {
+    constexpr iterator Insert(const_iterator cpos, const T& value) {
         return Emplace(cpos, value);
     }
 
-    iterator Insert(const_iterator cpos, T&& value) {
+    constexpr iterator Insert(const_iterator cpos, T&& value) {
         return Emplace(cpos, std::move(value));
     }
 
     template <typename... Types>
-    iterator Emplace(const_iterator cpos, Types&&... values) {
-        assert(cpos >= cbegin() && cpos <= cend());
-        iterator pos = const_cast<iterator>(cpos);
-        if (size_ == Capacity()) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : 2*Capacity());
-            if (size_ == 0) {
-                auto new_pos = new_data.GetAddress();
-                new (new_pos) T(std::forward<Types>(values)...);
-                data_.Swap(new_data);
-                ++size_;
-                return new_pos;
-            }
-            auto before{pos - begin()};
-            auto after{end() - pos};
-            T* new_pos = new_data + before;
-            new (new_pos) T(std::forward<Types>(values)...);
-            CopyData(begin(), before, new_data.GetAddress(), new_data, new_pos);
-            CopyData(pos, after, new_pos + 1, new_data, new_pos);
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-            ++size_;
-            return new_pos;
-        }
+    constexpr iterator Emplace(const_iterator cpos, Types&&... values) {
+        return MakeIterator(EmplaceAt(Unwrap(cpos, false), std::forward<Types>(values)...));
+    }
 
-        if (pos == end()) {
-            new (pos) T(std::forward<Types>(values)...);
-            ++size_;
-            return pos;
-        }
-        T tmp(std::forward<Types>(values)...);
-        new (end()) T(std::move(*(end() - 1)));
-        std::move_backward(pos, end() - 1, end());
-        *pos = std::move(tmp);
-        ++size_;
-        return pos;        
+    constexpr iterator Erase(const_iterator cpos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* pos = Unwrap(cpos, true);
+        return MakeIterator(EraseAt(pos, pos + 1));
     }
 
-    iterator Erase(const_iterator cpos) noexcept(std::is_nothrow_move_assignable_v<T>) {
-        assert(cpos >= cbegin() && cpos < cend());
-        iterator pos = const_cast<iterator>(cpos);\
-        std::move(pos + 1, end(), pos);
-        PopBack();
-        return pos;
+    // Удаляет элементы [cfirst, clast), сдвигая хвост за один проход
+    constexpr iterator EraseRange(const_iterator cfirst, const_iterator clast) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* first = Unwrap(cfirst, false);
+        T* last = Unwrap(clast, false);
+        Expect(first <= last, "EraseRange: invalid range");
+        return MakeIterator(EraseAt(first, last));
+    }
+
+    // Удаляет элемент за O(1): на его место переносится последний, порядок элементов не сохраняется.
+    // Возвращает итератор на элемент, занявший место удалённого, или end()
+    constexpr iterator EraseUnordered(const_iterator cpos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* pos = Unwrap(cpos, true);
+        const size_t index = pos - Data();
+        T* last = Data() + size_ - 1;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::destroy_at(pos);
+            if (pos != last) {
+                detail::UninitializedRelocate(last, 1, pos);
+            }
+            --size_;
+            MaybeShrink();
+        } else {
+            if (pos != last) {
+                *pos = std::move(*last);
+            }
+            PopBack();
+        }
+        return MakeIterator(Data() + index);
+    }
+
+    // Удаляет элементы, для которых pred истинен, за один проход, сохраняя порядок остальных.
+    // Если pred бросит исключение, часть элементов может остаться в состоянии после перемещения.
+    // Возвращает число удалённых элементов
+    template <typename Pred>
+    constexpr size_t EraseIf(Pred pred) {
+        T* new_end = std::remove_if(Data(), Data() + size_, std::ref(pred));
+        const size_t count = Data() + size_ - new_end;
+        EraseAt(new_end, Data() + size_);
+        return count;
+    }
+
+    // Удаляет элементы, для которых pred истинен, заполняя освободившиеся места элементами с конца.
+    // Переносит не больше элементов, чем удаляет; порядок оставшихся не сохраняется.
+    // Возвращает число удалённых элементов
+    template <typename Pred>
+    constexpr size_t EraseUnorderedIf(Pred pred) {
+        T* first = Data();
+        T* last = Data() + size_;
+        // Элементы [begin(), first) остаются, [last, end()) удаляются или уже перенесены
+        while (true) {
+            while (first != last && !pred(*first)) {
+                ++first;
+            }
+            if (first == last) {
+                break;
+            }
+            do {
+                --last;
+            } while (last != first && pred(*last));
+            if (last == first) {
+                break;
+            }
+            *first = std::move(*last);
+            ++first;
+        }
+        const size_t count = Data() + size_ - first;
+        EraseAt(first, Data() + size_);
+        return count;
+    }
+
+    // Сеанс дописывания элементов в зарезервированный хвост, возвращаемый GrowBy(n).
+    // Emplace создаёт элемент сразу в неинициализированной памяти без проверки вместимости
+    // (её проверяет лишь политика Checking). Размер вектора меняется при Commit() или
+    // уничтожении сеанса. Если сеанс уничтожается из-за исключения, созданные им элементы
+    // уничтожаются, а размер вектора остаётся прежним. Пока сеанс активен, вектор изменять нельзя
+    class AppendSession {
+    public:
+        AppendSession(const AppendSession&) = delete;
+        AppendSession& operator=(const AppendSession&) = delete;
+
+        ~AppendSession() {
+            if (std::uncaught_exceptions() > exceptions_) {
+                std::destroy(first_, pos_);
+            } else {
+                Commit();
+            }
+        }
+
+        // Аргументы могут ссылаться на элементы вектора: память не перевыделяется
+        template <typename... Types>
+        T& Emplace(Types&&... values) {
+            Vector::Expect(pos_ != last_, "AppendSession: no reserved space left");
+            T* elem = std::construct_at(pos_, std::forward<Types>(values)...);
+            ++pos_;
+            return *elem;
+        }
+
+        // Сколько ещё элементов можно создать
+        size_t Remaining() const noexcept {
+            return last_ - pos_;
+        }
+
+        // Добавляет созданные элементы к вектору. Сеанс можно продолжить
+        void Commit() noexcept {
+            vector_.size_ += pos_ - first_;
+            vector_.TrackCapacity();
+            first_ = pos_;
+        }
+
+    private:
+        friend class Vector;
+
+        AppendSession(Vector& vector, size_t count) noexcept
+            : vector_(vector)
+            , first_(vector.Data() + vector.size_)
+            , pos_(first_)
+            , last_(first_ + count) {
+        }
+
+        Vector& vector_;
+        T* first_;
+        T* pos_;
+        T* last_;
+        int exceptions_ = std::uncaught_exceptions();
+    };
+
+    // Резервирует место под count элементов в конце вектора и открывает сеанс их создания.
+    // Вместимость растёт по политике роста, поэтому частые сеансы не перевыделяют память каждый раз
+    AppendSession GrowBy(size_t count) {
+        if (count > Capacity() - size_) {
+            Reserve(NextCapacity(GrownSize(count)));
+        }
+        return AppendSession(*this, count);
     }
 
+    // Добавляет элементы [first, last) в конец. Хвоста за позицией вставки нет,
+    // поэтому сдвигать и поворачивать нечего
+    template <typename InputIt>
+    constexpr void Append(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            InsertCountedRange(size_, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+    // Вставляет элементы [first, last) перед cpos. Для прямых итераторов итоговый размер
+    // вычисляется заранее: память перевыделяется не более одного раза, а хвост
+    // сдвигается однократно. Диапазон не должен ссылаться на элементы самого вектора
+    template <typename InputIt>
+    constexpr iterator InsertRange(const_iterator cpos, InputIt first, InputIt last) {
+        const size_t index = Unwrap(cpos, false) - Data();
+        if constexpr (std::forward_iterator<InputIt>) {
+            InsertCountedRange(index, first, static_cast<size_t>(std::distance(first, last)));
+        } else {
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(Data() + index, Data() + old_size, Data() + size_);
+        }
+        return MakeIterator(Data() + index);
+    }
+
+    // Заменяет содержимое вектора элементами [first, last)
+    template <typename InputIt>
+    constexpr void Assign(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > Capacity()) {
+                Buffer new_data = AllocateBuffer(count);
+                detail::UninitializedCopyN(first, count, new_data.GetAddress());
+                std::destroy_n(data_.GetAddress(), size_);
+                ReplaceBuffer(new_data);
+            } else if (count <= size_) {
+                std::copy_n(first, count, Data());
+                std::destroy_n(data_ + count, size_ - count);
+            } else {
+                InputIt mid = std::next(first, size_);
+                std::copy(first, mid, Data());
+                detail::UninitializedCopyN(mid, count - size_, Data() + size_);
+            }
+            size_ = count;
+            TrackCapacity();
+        } else {
+            EraseAt(Data(), Data() + size_);
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+
+    // При исключении во время присваивания уже существующим элементам они остаются
+    // действительными, но часть из них может получить новые значения
+    template <typename Policy, std::random_access_iterator RandomIt>
+        requires is_parallel_policy_v<Policy>
+    void Assign(Policy&& /*policy*/, RandomIt first, RandomIt last) {
+        const size_t count = static_cast<size_t>(last - first);
+        if (count > Capacity()) {
+            Buffer new_data = AllocateBuffer(count);
+            ParallelUninitializedCopy(first, count, new_data.GetAddress());
+            ParallelDestroy(data_.GetAddress(), size_);
+            ReplaceBuffer(new_data);
+        } else {
+            T* data = data_.GetAddress();
+            detail::ForEachChunk(
+                std::min(count, size_),
+                [first, data](size_t from, size_t to) {
+                    std::copy(first + from, first + to, data + from);
+                },
+                [](size_t, size_t) {
+                });
+            if (count <= size_) {
+                ParallelDestroy(data + count, size_ - count);
+            } else {
+                ParallelUninitializedCopy(first + size_, count - size_, data + size_);
+            }
+        }
+        size_ = count;
+        TrackCapacity();
+    }
+
+    // Поиск, подсчёт, заполнение и свёртки по всем элементам. Для арифметических T
+    // выполняются SIMD-ядрами (simd.h), выбранными по возможностям процессора, иначе и при вычислении
+    // во время компиляции — алгоритмами std
+    constexpr iterator Find(const T& value) {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return MakeIterator(Data() + detail::simd::Find<kBufferAlignment>(data_.GetAddress(), size_, value));
+            }
+        }
+        return MakeIterator(std::find(Data(), Data() + size_, value));
+    }
+
+    constexpr const_iterator Find(const T& value) const {
+        return const_cast<Vector&>(*this).Find(value);
+    }
+
+    constexpr size_t Count(const T& value) const {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return detail::simd::Count<kBufferAlignment>(data_.GetAddress(), size_, value);
+            }
+        }
+        return static_cast<size_t>(std::count(Data(), Data() + size_, value));
+    }
+
+    constexpr void Fill(const T& value) {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                detail::simd::Fill<kBufferAlignment>(data_.GetAddress(), size_, value);
+                return;
+            }
+        }
+        std::fill(Data(), Data() + size_, value);
+    }
 
-    size_t Size() const noexcept {
+    // Наименьший и наибольший элементы непустого вектора
+    constexpr std::pair<T, T> MinMax() const {
+        Expect(size_ > 0, "MinMax of an empty vector");
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return detail::simd::MinMax<kBufferAlignment>(data_.GetAddress(), size_);
+            }
+        }
+        const auto [min, max] = std::minmax_element(Data(), Data() + size_);
+        return {*min, *max};
+    }
+
+    // Сумма элементов. Вещественные ядра складывают в другом порядке, чем std::accumulate
+    constexpr T Sum() const {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return detail::simd::Sum<kBufferAlignment>(data_.GetAddress(), size_);
+            }
+        }
+        return std::accumulate(Data(), Data() + size_, T{});
+    }
+
+    constexpr bool operator==(const Vector& other) const {
+        if (size_ != other.size_) {
+            return false;
+        }
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return detail::simd::Equal<kBufferAlignment>(data_.GetAddress(), other.data_.GetAddress(), size_);
+            }
+        }
+        return std::equal(Data(), Data() + size_, other.Data());
+    }
+
+    constexpr size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    constexpr size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    constexpr const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
-        assert(index < size_);
+    constexpr T& operator[](size_t index) noexcept {
+        Expect(index < size_, "index out of range");
         return data_[index];
     }
 
-    void Swap(Vector& other) noexcept {
+    // Элементы лежат в памяти подряд, начиная с Data()
+    constexpr T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    // Элементы [offset, offset + count) без копирования; по умолчанию — до конца вектора.
+    // Как и итераторы, span становится недействительным при перевыделении памяти
+    constexpr std::span<T> Subspan(size_t offset, size_t count = std::dynamic_extent) noexcept {
+        Expect(offset <= size_, "Subspan: offset out of range");
+        if (count == std::dynamic_extent) {
+            count = size_ - offset;
+        }
+        Expect(count <= size_ - offset, "Subspan: count out of range");
+        return {Data() + offset, count};
+    }
+
+    constexpr std::span<const T> Subspan(size_t offset, size_t count = std::dynamic_extent) const noexcept {
+        return const_cast<Vector&>(*this).Subspan(offset, count);
+    }
+
+    constexpr operator std::span<const T>() const noexcept {
+        return {Data(), size_};
+    }
+
+    // Заменяет содержимое буфером, в котором живы первые size элементов, не копируя их.
+    // Вектор перенимает и аллокатор буфера; неперемещаемые аллокаторы (pmr) должны быть равны.
+    // Буфер из C API передаётся через RawMemory(pointer, capacity, alloc)
+    constexpr void Adopt(Buffer&& buffer, size_t size) noexcept {
+        Expect(size <= buffer.Capacity(), "Adopt: size exceeds capacity");
+        Buffer new_data(std::move(buffer));
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = size;
+        ReplaceBuffer(new_data);
+        CountAllocation();
+    }
+
+    // Отдаёт буфер вместе с числом живых элементов в его начале; вектор становится пустым.
+    // Уничтожить элементы и освободить память теперь должен получатель
+    constexpr std::pair<Buffer, size_t> Release() noexcept requires(!Storage::kHasInlineStorage) {
+        const size_t size = std::exchange(size_, 0);
+        Buffer buffer(data_.GetAllocator());
+        ReplaceBuffer(buffer);
+        TrackCapacity();
+        return {std::move(buffer), size};
+    }
+
+    constexpr allocator_type GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Снимок статистики, собранной политикой Stats. Для NoStats все счётчики нулевые
+    constexpr VectorStatsSnapshot GetStats() const noexcept {
+        return stats_.Snapshot(Capacity() * sizeof(T), size_ * sizeof(T));
+    }
+
+    // Итераторы DebugChecks после обмена становятся недействительными
+    constexpr void Swap(Vector& other) noexcept(kNothrowSwap) {
+        generation_.Bump();
+        other.generation_.Bump();
+        if constexpr (Storage::kHasInlineStorage) {
+            if (data_.IsInline() || other.data_.IsInline()) {
+                assert(this->GetAllocator() == other.GetAllocator());
+                Vector tmp(std::move(other));
+                other.MoveFrom(*this);
+                MoveFrom(tmp);
+                TrackCapacity();
+                other.TrackCapacity();
+                return;
+            }
+        }
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
+        TrackCapacity();
+        other.TrackCapacity();
     }
 
-    ~Vector() {
+    constexpr ~Vector() {
         if (size_) {
             std::destroy_n(data_.GetAddress(), size_);
         };
+        stats_.OnCapacityChange(0, 0);
     }
 
 private:
+    static constexpr bool kPropagateOnCopy = AllocTraits::propagate_on_container_copy_assignment::value;
+    static constexpr bool kPropagateOnMove = AllocTraits::propagate_on_container_move_assignment::value;
+
+    // Копирует other с аллокатором alloc, ведя статистику в stats
+    constexpr Vector(const Vector& other, const Alloc& alloc, const Stats& stats)
+        : data_(other.size_, alloc)
+        , size_(other.size_)
+        , stats_(stats) {
+        detail::UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
+        CountAllocation();
+    }
+
+    // Выделяет буфер для роста и учитывает его в статистике
+    constexpr Buffer AllocateBuffer(size_t capacity) {
+        Buffer new_data(capacity, data_.GetAllocator());
+        stats_.OnAllocate(capacity * sizeof(T));
+        return new_data;
+    }
+
+    // Учитывает динамический буфер, полученный вектором при создании или копировании
+    constexpr void CountAllocation() noexcept {
+        if (HasHeapBuffer()) {
+            stats_.OnAllocate(Capacity() * sizeof(T));
+        }
+        TrackCapacity();
+    }
+
+    constexpr void CountRelocation(size_t count) noexcept {
+        if (count != 0) {
+            stats_.OnRelocate(count * sizeof(T), kRelocationKind);
+        }
+    }
+
+    // Сообщает политике статистики текущие вместимость и размер
+    constexpr void TrackCapacity() noexcept {
+        stats_.OnCapacityChange(Capacity() * sizeof(T), size_ * sizeof(T));
+    }
+
+    // Первое выделение через Reallocate учитывается как обычное. Возвращает адрес нового буфера
+    T* ReallocateInPlace(size_t new_capacity) {
+        const bool had_buffer = Capacity() != 0;
+        data_.Reallocate(new_capacity);
+        generation_.Bump();
+        if (had_buffer) {
+            stats_.OnReallocate(new_capacity * sizeof(T));
+        } else {
+            stats_.OnAllocate(new_capacity * sizeof(T));
+        }
+        return data_.GetAddress();
+    }
+
+    // Уничтожает лишние элементы либо резервирует память под new_size элементов.
+    // Возвращает true, если в хвосте нужно создать недостающие элементы
+    constexpr bool PrepareResize(size_t new_size) {
+        if (new_size <= size_) {
+            std::destroy_n(data_ + new_size, size_ - new_size);
+            size_ = new_size;
+            MaybeShrink();
+            return false;
+        }
+        if (new_size > Capacity()) {
+            Reserve(NextCapacity(new_size));
+        }
+        return true;
+    }
+
+    // Вместимость, до которой растёт вектор, когда ему нужно вместить required элементов
+    constexpr size_t NextCapacity(size_t required) const noexcept {
+        return Growth::NextCapacity(Capacity(), required, sizeof(T));
+    }
+
+    static constexpr size_t kMaxSize = static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T);
+
+    // Размер вектора после добавления count элементов. Буфер не может быть длиннее PTRDIFF_MAX байт;
+    // проверка заодно даёт компилятору верхнюю границу size_, без которой GCC при -O3
+    // предупреждает о memcpy огромной длины при переносе элементов в новый буфер
+    constexpr size_t GrownSize(size_t count) const {
+        if (count > kMaxSize || size_ > kMaxSize - count) {
+            throw std::length_error("Vector: too many elements");
+        }
+        return size_ + count;
+    }
+
+    static constexpr bool kAutoShrink = requires(size_t n) {
+        { Growth::ShrinkCapacity(n, n, n) } -> std::convertible_to<size_t>;
+    };
+
+    // Уменьшает вместимость по решению политики роста. Уменьшение необязательно,
+    // поэтому при нехватке памяти или исключении при переносе буфер остаётся прежним
+    constexpr void MaybeShrink() noexcept {
+        if constexpr (kAutoShrink) {
+            const size_t new_capacity = std::max<size_t>(Growth::ShrinkCapacity(Capacity(), size_, sizeof(T)), size_);
+            if (new_capacity < Capacity()) {
+                try {
+                    SetCapacity(new_capacity);
+                } catch (...) {
+                }
+            }
+        }
+    }
+
+    // Переносит элементы в буфер на new_capacity >= size_ элементов. Если такая вместимость
+    // помещается во встроенный буфер хранилища (для RawMemory — нулевая), динамический освобождается
+    constexpr void SetCapacity(size_t new_capacity) {
+        assert(new_capacity >= size_);
+        if (new_capacity <= Storage::kInlineCapacity) {
+            if (HasHeapBuffer()) {
+                ReleaseHeapBuffer();
+            }
+        } else if constexpr (kReallocateInPlace) {
+            ReallocateInPlace(new_capacity);
+        } else {
+            Buffer new_data = AllocateBuffer(new_capacity);
+            RelocateInNewData(data_.GetAddress(), size_, new_data.GetAddress());
+            CountRelocation(size_);
+            ReplaceBuffer(new_data);
+        }
+        TrackCapacity();
+    }
+
+    // Освобождает динамический буфер, перенося элементы во встроенный
+    constexpr void ReleaseHeapBuffer() {
+        Buffer old_data(data_.GetAllocator());
+        data_.Swap(old_data);
+        generation_.Bump();
+        if constexpr (!Storage::kHasInlineStorage) {
+            assert(size_ == 0);
+            return;
+        }
+        try {
+            RelocateInNewData(old_data.GetAddress(), size_, data_.GetAddress());
+        } catch (...) {
+            data_.Swap(old_data);
+            throw;
+        }
+        CountRelocation(size_);
+    }
 
-    void CopyWithOldCapacity(const Vector& rhs) {
-        const size_t copy_size = (rhs.Size() < this->Size()) ? rhs.Size() : this->Size();
-        (rhs.Size() < this->Size()) ? 
-            std::destroy_n(data_ + rhs.Size(), size_ - rhs.Size()) :
-            std::uninitialized_copy_n(rhs.data_ + this->Size(), rhs.Size() - size_, data_.GetAddress());
-        std::copy(rhs.data_.GetAddress(), rhs.data_ + copy_size, data_.GetAddress());
-        size_ = rhs.Size();  
+    constexpr bool HasHeapBuffer() const noexcept {
+        if constexpr (Storage::kHasInlineStorage) {
+            return !data_.IsInline();
+        } else {
+            return Capacity() != 0;
+        }
     }
 
-    static void CopyOrMoveInNewData(T* from, size_t size, T* to) {
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(from, size, to);
+    // Выравнивание начала буфера: аллокатор может гарантировать большее, чем alignof(T)
+    static constexpr size_t kBufferAlignment = [] {
+        if constexpr (requires { Alloc::alignment; } && std::is_same_v<Storage, Buffer>) {
+            return std::max<size_t>(Alloc::alignment, alignof(T));
+        } else {
+            return alignof(T);
+        }
+    }();
+
+    // Буфер можно растить на месте: элементы переносятся побайтово, а аллокатор умеет realloc
+    static constexpr bool kReallocateInPlace = is_trivially_relocatable_v<T> && std::is_same_v<Storage, Buffer>
+                                               && Buffer::kCanReallocate;
+
+    // Встроенные элементы при обмене и перемещении приходится переносить по одному
+    static constexpr bool kNothrowSwap = !Storage::kHasInlineStorage || is_trivially_relocatable_v<T>
+                                         || std::is_nothrow_move_constructible_v<T>;
+
+    // Забирает содержимое other. Вектор должен быть пуст и не владеть динамическим буфером
+    constexpr void MoveFrom(Vector& other) noexcept(kNothrowSwap) {
+        assert(size_ == 0 && data_.IsInline());
+        if (other.data_.IsInline()) {
+            RelocateInNewData(other.data_.GetAddress(), other.size_, data_.GetAddress());
         } else {
-            std::uninitialized_copy_n(from, size, to);
+            data_.Swap(other.data_);
+        }
+        size_ = std::exchange(other.size_, 0);
+    }
+
+    // Создаёт элемент перед pos и возвращает указатель на него
+    template <typename... Types>
+    constexpr T* EmplaceAt(T* pos, Types&&... values) {
+        if (size_ == Capacity()) {
+            // Смещения считаются до выделения памяти: после вызова аллокатора компилятор
+            // не видит, что у EmplaceBack хвост пуст, и предупреждает о memcpy огромной длины
+            const size_t before = pos - Data();
+            if constexpr (kReallocateInPlace) {
+                return EmplaceWithReallocate(before, NextCapacity(GrownSize(1)), std::forward<Types>(values)...);
+            } else {
+                const size_t after = size_ - before;
+                Buffer new_data = AllocateBuffer(NextCapacity(GrownSize(1)));
+                if (size_ == 0) {
+                    auto new_pos = new_data.GetAddress();
+                    std::construct_at(new_pos, std::forward<Types>(values)...);
+                    ReplaceBuffer(new_data);
+                    ++size_;
+                    TrackCapacity();
+                    return new_pos;
+                }
+                T* new_pos = new_data + before;
+                std::construct_at(new_pos, std::forward<Types>(values)...);
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    RelocateInNewData(Data(), before, new_data.GetAddress());
+                    if (after != 0) {
+                        RelocateInNewData(pos, after, new_pos + 1);
+                    }
+                } else {
+                    CopyData(Data(), before, new_data.GetAddress(), new_data, new_pos);
+                    CopyData(pos, after, new_pos + 1, new_data, new_pos);
+                    std::destroy_n(data_.GetAddress(), size_);
+                }
+                CountRelocation(size_);
+                ReplaceBuffer(new_data);
+                ++size_;
+                TrackCapacity();
+                return new_pos;
+            }
+        }
+
+        detail::EmplaceInPlace(Data(), size_, pos, std::forward<Types>(values)...);
+        return pos;
+    }
+
+    // Удаляет элементы [first, last) и возвращает указатель на элемент, занявший место first
+    constexpr T* EraseAt(T* first, T* last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const size_t index = first - Data();
+        if (first == last) {
+            return first;
         }
+        detail::EraseInPlace(Data(), size_, first, last);
+        MaybeShrink();
+        return Data() + index;
     }
 
-    void CopyData(T* from, size_t size, T* to, RawMemory<T>& new_data, T* new_pos) {
+    // Аргументы могут ссылаться на элементы вектора, а после Reallocate старый буфер
+    // может оказаться освобождён, поэтому новый элемент создаётся заранее во временной
+    // памяти и затем переносится на место побайтово
+    template <typename... Types>
+    T* EmplaceWithReallocate(size_t index, size_t new_capacity, Types&&... values) {
+        alignas(T) std::byte slot[sizeof(T)];
+        T* tmp = new (slot) T(std::forward<Types>(values)...);
+        T* new_data = nullptr;
+        try {
+            new_data = ReallocateInPlace(new_capacity);
+        } catch (...) {
+            tmp->~T();
+            throw;
+        }
+        assert(new_data != nullptr);
+        T* new_pos = new_data + index;
+        if (index != size_) {
+            std::memmove(static_cast<void*>(new_pos + 1), static_cast<const void*>(new_pos), (size_ - index) * sizeof(T));
+        }
+        std::memcpy(static_cast<void*>(new_pos), static_cast<const void*>(tmp), sizeof(T));
+        ++size_;
+        TrackCapacity();
+        return new_pos;
+    }
+
+    // Вставляет count элементов, начиная с first, на позицию index
+    template <typename ForwardIt>
+    constexpr void InsertCountedRange(size_t index, ForwardIt first, size_t count) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > Capacity()) {
+            if constexpr (kReallocateInPlace) {
+                Reserve(NextCapacity(GrownSize(count)));
+            } else {
+                Buffer new_data = AllocateBuffer(NextCapacity(GrownSize(count)));
+                T* new_pos = new_data + index;
+                detail::UninitializedCopyN(first, count, new_pos);
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    RelocateInNewData(Data(), index, new_data.GetAddress());
+                    RelocateInNewData(Data() + index, size_ - index, new_pos + count);
+                } else {
+                    CopyData(Data(), index, new_data.GetAddress(), new_data, new_pos, count);
+                    CopyData(Data() + index, size_ - index, new_pos + count, new_data, new_pos, count);
+                    std::destroy_n(data_.GetAddress(), size_);
+                }
+                CountRelocation(size_);
+                ReplaceBuffer(new_data);
+                size_ += count;
+                TrackCapacity();
+                return;
+            }
+        }
+
+        detail::InsertInPlace(Data(), size_, index, first, count);
+    }
+
+    // Перемещает элементы rhs поэлементно, когда забрать его буфер нельзя:
+    // аллокаторы различны и не распространяются при перемещающем присваивании
+    constexpr void MoveWithOwnAllocator(Vector& rhs) {
+        Vector tmp(this->GetAllocator());
+        tmp.Reserve(rhs.Size());
+        detail::UninitializedMoveN(rhs.data_.GetAddress(), rhs.Size(), tmp.data_.GetAddress());
+        tmp.size_ = rhs.Size();
+        this->Swap(tmp);
+        CountAllocation();
+    }
+
+    // Копирует rhs в буфер, вместимости которого хватает: общая часть присваивается,
+    // недостающие элементы создаются за ней, лишние уничтожаются
+    constexpr void CopyWithOldCapacity(const Vector& rhs) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                if (rhs.size_ != 0) {
+                    std::memcpy(static_cast<void*>(Data()), static_cast<const void*>(rhs.Data()), rhs.size_ * sizeof(T));
+                }
+                size_ = rhs.size_;
+                return;
+            }
+        }
+        if (rhs.size_ <= size_) {
+            std::copy_n(rhs.Data(), rhs.size_, Data());
+            std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+        } else {
+            std::copy_n(rhs.Data(), size_, Data());
+            detail::UninitializedCopyN(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+        }
+        size_ = rhs.size_;
+    }
+
+    static constexpr bool kMoveOnRelocate = detail::kMoveOnRelocate<T>;
+    static constexpr RelocationKind kRelocationKind = is_trivially_relocatable_v<T> ? RelocationKind::kMemcpy
+                                                      : kMoveOnRelocate            ? RelocationKind::kMove
+                                                                                   : RelocationKind::kCopy;
+
+    static constexpr void CopyOrMoveInNewData(T* from, size_t size, T* to) {
+        detail::UninitializedCopyOrMove(from, size, to);
+    }
+
+    static constexpr void RelocateInNewData(T* from, size_t size, T* to) {
+        detail::UninitializedRelocate(from, size, to);
+    }
+
+    // Копирует count элементов, начиная с first, в неинициализированную память to
+    template <typename RandomIt>
+    static void ParallelUninitializedCopy(RandomIt first, size_t count, T* to) {
+        detail::ForEachChunk(
+            count,
+            [first, to](size_t from, size_t last) {
+                std::uninitialized_copy(first + from, first + last, to + from);
+            },
+            [to](size_t from, size_t last) {
+                std::destroy(to + from, to + last);
+            });
+    }
+
+    static void ParallelDestroy(T* data, size_t count) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            detail::ForEachChunk(
+                count,
+                [data](size_t first, size_t last) {
+                    std::destroy(data + first, data + last);
+                },
+                [](size_t, size_t) {
+                });
+        }
+    }
+
+    constexpr void CopyData(T* from, size_t size, T* to, Buffer& new_data, T* new_pos, size_t new_count = 1) {
         try {
             CopyOrMoveInNewData(from, size, to);
         } catch(...) {
-            new_pos->~T();
-            std::destroy_n(new_data.GetAddress(), from - begin());
+            std::destroy_n(new_pos, new_count);
+            std::destroy_n(new_data.GetAddress(), from - Data());
             throw;
         }
     }
 
+    // Проверяет предусловие. NoChecks ограничивается assert, остальные политики
+    // вызывают обработчик нарушения и в сборках с NDEBUG
+    static constexpr void Expect(bool condition, [[maybe_unused]] const char* what) noexcept {
+        if constexpr (Checking::kBounds) {
+            if (!condition) [[unlikely]] {
+                Checking::Fail(what);
+            }
+        } else {
+            assert(condition && what);
+        }
+    }
+
+    constexpr iterator MakeIterator(T* ptr) noexcept {
+        if constexpr (Checking::kIterators) {
+            return iterator(ptr, this);
+        } else {
+            return ptr;
+        }
+    }
+
+    // Указатель на позицию pos в [begin(), end()], а если нужен элемент — в [begin(), end()).
+    // Итератор DebugChecks должен быть получен от этого вектора после последней смены буфера
+    constexpr T* Unwrap(const_iterator pos, bool need_element) noexcept {
+        const T* ptr;
+        if constexpr (Checking::kIterators) {
+            Expect(pos.owner_ == this && pos.generation_ == generation_.value, "invalidated iterator");
+            ptr = pos.ptr_;
+        } else {
+            ptr = pos;
+        }
+        const T* end = Data() + size_;
+        Expect(ptr >= Data() && (need_element ? ptr < end : ptr <= end), "iterator out of range");
+        return const_cast<T*>(ptr);
+    }
+
+    // Заменяет буфер новым; итераторы на прежний становятся недействительными
+    constexpr void ReplaceBuffer(Buffer& new_data) noexcept {
+        data_.Swap(new_data);
+        generation_.Bump();
+    }
 
-    RawMemory<T> data_;
+    Storage data_;
     size_t size_ = 0;
+    [[no_unique_address]] Stats stats_;
+    [[no_unique_address]] std::conditional_t<Checking::kIterators, detail::BufferGeneration, detail::NoBufferGeneration>
+        generation_;
+};
+
+// Итератор DebugChecks: указатель на элемент, вектор и поколение его буфера на момент создания.
+// Разыменование проверяет, что буфер не менялся и элемент существует; арифметика не проверяется
+template <typename T, typename Alloc, typename Growth, typename Storage, typename Stats, typename Checking>
+template <bool Const>
+class Vector<T, Alloc, Growth, Storage, Stats, Checking>::CheckedIterator {
+    using Owner = std::conditional_t<Const, const Vector, Vector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    constexpr CheckedIterator() = default;
+
+    constexpr CheckedIterator(pointer ptr, Owner* owner) noexcept
+        : ptr_(ptr)
+        , owner_(owner)
+        , generation_(owner->generation_.value) {
+    }
+
+    constexpr operator CheckedIterator<true>() const noexcept requires(!Const) {
+        CheckedIterator<true> it;
+        it.ptr_ = ptr_;
+        it.owner_ = owner_;
+        it.generation_ = generation_;
+        return it;
+    }
+
+    constexpr reference operator*() const noexcept {
+        Check();
+        return *ptr_;
+    }
+
+    constexpr pointer operator->() const noexcept {
+        Check();
+        return ptr_;
+    }
+
+    constexpr reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    constexpr CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator++(int) noexcept {
+        CheckedIterator old = *this;
+        ++ptr_;
+        return old;
+    }
+
+    constexpr CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator--(int) noexcept {
+        CheckedIterator old = *this;
+        --ptr_;
+        return old;
+    }
+
+    constexpr CheckedIterator& operator+=(difference_type n) noexcept {
+        ptr_ += n;
+        return *this;
+    }
+
+    constexpr CheckedIterator& operator-=(difference_type n) noexcept {
+        ptr_ -= n;
+        return *this;
+    }
+
+    friend constexpr CheckedIterator operator+(CheckedIterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend constexpr CheckedIterator operator+(difference_type n, CheckedIterator it) noexcept {
+        return it += n;
+    }
+
+    friend constexpr CheckedIterator operator-(CheckedIterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend constexpr difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    friend constexpr bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend constexpr auto operator<=>(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ <=> rhs.ptr_;
+    }
+
+private:
+    friend class Vector;
+    friend class CheckedIterator<!Const>;
+
+    constexpr void Check() const noexcept {
+        Expect(owner_ && generation_ == owner_->generation_.value, "invalidated iterator");
+        Expect(ptr_ >= owner_->Data() && ptr_ < owner_->Data() + owner_->size_, "iterator out of range");
+    }
+
+    pointer ptr_ = nullptr;
+    const Vector* owner_ = nullptr;
+    size_t generation_ = 0;
 };
+
+// Итераторы DebugChecks хранят адрес вектора, поэтому такой вектор переносится только конструктором
+template <typename T, typename Alloc, typename Growth, typename Storage, typename Stats, typename Checking>
+struct is_trivially_relocatable<Vector<T, Alloc, Growth, Storage, Stats, Checking>>
+    : std::conjunction<is_trivially_relocatable<Storage>, is_trivially_relocatable<Stats>,
+                       std::bool_constant<!Checking::kIterators>> {
+};
+
+// Копирует вектор, построенный во время компиляции функцией make, в std::array.
+// Память, выделенная при константном вычислении, должна быть освобождена до его конца,
+// поэтому make вызывается дважды: для размера массива и для самих элементов.
+// Результат можно сохранить в static constexpr переменную без инициализации при запуске
+template <auto Make>
+consteval auto ToStaticArray() {
+    using T = std::remove_cvref_t<decltype(*Make().begin())>;
+    constexpr size_t kSize = Make().Size();
+    std::array<T, kSize> result{};
+    const auto vector = Make();
+    std::copy(vector.begin(), vector.end(), result.begin());
+    return result;
+}
+
+// Вектор, хранящий до N элементов без обращения к динамической памяти
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth,
+          typename Stats = NoStats, typename Checking = DefaultChecks>
+using SmallVector = Vector<T, Alloc, Growth, SmallStorage<T, N, Alloc>, Stats, Checking>;
+
+namespace pmr {
+
+// Вектор, получающий память из std::pmr::memory_resource (арены, пулы и т.п.)
+template <typename T>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace pmr
@@ -0,0 +1,907 @@
+#include "vector.h"
+#include "allocators.h"
+#include "concurrent_vector.h"
+#include "flat_map.h"
+#include "gap_vector.h"
+#include "inplace_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "vector_execution.h"
+#include "vector_io.h"
+#include "vector_serialization.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Счётчики выделений памяти, общие для всех контейнеров бенчмарка
+struct AllocationCounters {
+    static void Reset() {
+        allocations = 0;
+        allocated_bytes = 0;
+        released_bytes = 0;
+        live_bytes = 0;
+        peak_bytes = 0;
+    }
+
+    static inline size_t allocations = 0;
+    static inline size_t allocated_bytes = 0;
+    // Блоки, освобождённые при росте контейнера: их содержимое было перенесено в новый буфер
+    static inline size_t released_bytes = 0;
+    static inline size_t live_bytes = 0;
+    static inline size_t peak_bytes = 0;
+};
+
+template <typename T>
+struct BenchAllocator {
+    using value_type = T;
+
+    BenchAllocator() = default;
+
+    template <typename U>
+    BenchAllocator(const BenchAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        ++AllocationCounters::allocations;
+        AllocationCounters::allocated_bytes += n * sizeof(T);
+        AllocationCounters::live_bytes += n * sizeof(T);
+        AllocationCounters::peak_bytes = std::max(AllocationCounters::peak_bytes, AllocationCounters::live_bytes);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        AllocationCounters::released_bytes += n * sizeof(T);
+        AllocationCounters::live_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const BenchAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+struct Pod64 {
+    std::array<int32_t, 16> values;
+};
+static_assert(sizeof(Pod64) == 64);
+
+using MoveOnly = std::unique_ptr<int>;
+
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        Pod64 pod{};
+        pod.values.fill(static_cast<int32_t>(i));
+        return pod;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        // Длиннее буфера SSO, чтобы строка владела динамической памятью
+        return std::string(32, static_cast<char>('a' + i % 26));
+    } else {
+        return std::make_unique<int>(static_cast<int>(i));
+    }
+}
+
+template <typename T>
+size_t Weight(const T& value) {
+    if constexpr (std::is_same_v<T, int>) {
+        return static_cast<size_t>(value);
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return static_cast<size_t>(value.values[0]);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return value.size();
+    } else {
+        return static_cast<size_t>(*value);
+    }
+}
+
+// Единый интерфейс к std::vector и Vector
+
+template <typename T, typename A>
+void PushBack(std::vector<T, A>& c, T&& value) {
+    c.push_back(std::move(value));
+}
+
+template <typename T, typename... Params>
+void PushBack(Vector<T, Params...>& c, T&& value) {
+    c.PushBack(std::move(value));
+}
+
+template <typename T, typename A, size_t N>
+void PushBack(SegmentedVector<T, A, N>& c, T&& value) {
+    c.PushBack(std::move(value));
+}
+
+template <typename T, typename A, typename G>
+void PushBack(GapVector<T, A, G>& c, T&& value) {
+    c.PushBack(std::move(value));
+}
+
+template <typename T, size_t N>
+void PushBack(InplaceVector<T, N>& c, T&& value) {
+    c.PushBack(std::move(value));
+}
+
+template <typename T, typename A>
+void EmplaceBack(std::vector<T, A>& c, size_t i) {
+    c.emplace_back(MakeValue<T>(i));
+}
+
+template <typename T, typename... Params>
+void EmplaceBack(Vector<T, Params...>& c, size_t i) {
+    c.EmplaceBack(MakeValue<T>(i));
+}
+
+template <typename T, typename A>
+void Reserve(std::vector<T, A>& c, size_t n) {
+    c.reserve(n);
+}
+
+template <typename T, typename... Params>
+void Reserve(Vector<T, Params...>& c, size_t n) {
+    c.Reserve(n);
+}
+
+template <typename T, typename A, size_t N>
+void Reserve(SegmentedVector<T, A, N>& c, size_t n) {
+    c.Reserve(n);
+}
+
+template <typename T, typename A, typename G>
+void Reserve(GapVector<T, A, G>& c, size_t n) {
+    c.Reserve(n);
+}
+
+template <typename T, typename A>
+void InsertAt(std::vector<T, A>& c, size_t index, T&& value) {
+    c.insert(c.begin() + index, std::move(value));
+}
+
+template <typename T, typename... Params>
+void InsertAt(Vector<T, Params...>& c, size_t index, T&& value) {
+    c.Insert(c.begin() + index, std::move(value));
+}
+
+template <typename T, typename A, typename G>
+void InsertAt(GapVector<T, A, G>& c, size_t index, T&& value) {
+    c.Insert(index, std::move(value));
+}
+
+template <typename T, typename A>
+void EraseAt(std::vector<T, A>& c, size_t index) {
+    c.erase(c.begin() + index);
+}
+
+template <typename T, typename... Params>
+void EraseAt(Vector<T, Params...>& c, size_t index) {
+    c.Erase(c.begin() + index);
+}
+
+template <typename T, typename A, typename G>
+void EraseAt(GapVector<T, A, G>& c, size_t index) {
+    c.Erase(index);
+}
+
+template <typename Container>
+using ValueOf = std::remove_cvref_t<decltype(*std::declval<Container&>().begin())>;
+
+template <typename Container>
+Container MakeFilled(size_t n) {
+    using T = ValueOf<Container>;
+    Container c;
+    Reserve(c, n);
+    for (size_t i = 0; i < n; ++i) {
+        PushBack(c, MakeValue<T>(i));
+    }
+    return c;
+}
+
+// ns/op — время одной операции, allocs — выделений памяти за итерацию,
+// bytes_copied — объём буферов, содержимое которых переносилось при росте контейнера
+void ReportCounters(benchmark::State& state, size_t ops, size_t copied_bytes = 0) {
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["ns/op"] = benchmark::Counter(static_cast<double>(ops) * iterations,
+                                                 benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs"] = static_cast<double>(AllocationCounters::allocations) / iterations;
+    state.counters["bytes_copied"] = static_cast<double>(copied_bytes) / iterations;
+}
+
+template <typename Container>
+void BM_PushBack(benchmark::State& state) {
+    using T = ValueOf<Container>;
+    const auto n = static_cast<size_t>(state.range(0));
+    AllocationCounters::Reset();
+    size_t copied = 0;
+    for (auto _ : state) {
+        AllocationCounters::released_bytes = 0;
+        Container c;
+        for (size_t i = 0; i < n; ++i) {
+            PushBack(c, MakeValue<T>(i));
+        }
+        benchmark::DoNotOptimize(c.begin());
+        copied += AllocationCounters::released_bytes;
+    }
+    ReportCounters(state, n, copied);
+}
+
+template <typename Container>
+void BM_EmplaceBack(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    AllocationCounters::Reset();
+    size_t copied = 0;
+    for (auto _ : state) {
+        AllocationCounters::released_bytes = 0;
+        Container c;
+        for (size_t i = 0; i < n; ++i) {
+            EmplaceBack(c, i);
+        }
+        benchmark::DoNotOptimize(c.begin());
+        copied += AllocationCounters::released_bytes;
+    }
+    ReportCounters(state, n, copied);
+}
+
+// Перенос заполненного буфера в буфер вдвое большего размера
+template <typename Container>
+void BM_Reserve(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    size_t allocations = 0;
+    size_t copied = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Container c = MakeFilled<Container>(n);
+        AllocationCounters::Reset();
+        state.ResumeTiming();
+
+        Reserve(c, n * 2);
+        benchmark::DoNotOptimize(c.begin());
+
+        state.PauseTiming();
+        allocations += AllocationCounters::allocations;
+        copied += AllocationCounters::released_bytes;
+        c = Container{};
+        state.ResumeTiming();
+    }
+    ReportCounters(state, n, copied);
+    state.counters["allocs"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+}
+
+enum class Position { kFront, kMiddle, kBack };
+
+// Вставка и удаление одного элемента при неизменном размере контейнера
+template <typename Container, Position Where>
+void BM_InsertErase(benchmark::State& state) {
+    using T = ValueOf<Container>;
+    const auto n = static_cast<size_t>(state.range(0));
+    Container c = MakeFilled<Container>(n);
+    Reserve(c, n + 1);
+    const size_t index = Where == Position::kFront ? 0 : Where == Position::kMiddle ? n / 2 : n;
+    AllocationCounters::Reset();
+    for (auto _ : state) {
+        InsertAt(c, index, MakeValue<T>(index));
+        EraseAt(c, index);
+        benchmark::DoNotOptimize(c.begin());
+    }
+    ReportCounters(state, 1);
+}
+
+// Копирующее присваивание в контейнер, которому хватает вместимости
+template <typename Container>
+void BM_CopyAssign(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Container src = MakeFilled<Container>(n);
+    Container dst = MakeFilled<Container>(n);
+    AllocationCounters::Reset();
+    for (auto _ : state) {
+        dst = src;
+        benchmark::DoNotOptimize(dst.begin());
+    }
+    ReportCounters(state, n);
+}
+
+template <typename Container>
+void BM_Iterate(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Container c = MakeFilled<Container>(n);
+    AllocationCounters::Reset();
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const auto& value : c) {
+            sum += Weight(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportCounters(state, n);
+}
+
+// Для int размеры доходят до 10^8, для крупных элементов — до 10^6
+template <typename T>
+void Sizes(benchmark::internal::Benchmark* bench) {
+    const int64_t max_size = std::is_same_v<T, int> ? 100'000'000 : 1'000'000;
+    for (int64_t size = 8; size <= max_size; size *= 10) {
+        bench->Arg(size);
+    }
+}
+
+template <typename T>
+void InsertSizes(benchmark::internal::Benchmark* bench) {
+    for (int64_t size = 8; size <= 100'000; size *= 10) {
+        bench->Arg(size);
+    }
+}
+
+template <typename T>
+using StdVector = std::vector<T, BenchAllocator<T>>;
+
+template <typename T>
+using AdvancedVector = Vector<T, BenchAllocator<T>>;
+
+template <typename T>
+using AdvancedSmallVector = SmallVector<T, 8, BenchAllocator<T>>;
+
+template <typename T>
+using AdvancedOneAndHalfVector = Vector<T, BenchAllocator<T>, OneAndHalfGrowth>;
+
+#define VECTOR_BENCHMARKS(Container, T)                                                  \
+    BENCHMARK_TEMPLATE(BM_PushBack, Container<T>)->Apply(Sizes<T>);                      \
+    BENCHMARK_TEMPLATE(BM_EmplaceBack, Container<T>)->Apply(Sizes<T>);                   \
+    BENCHMARK_TEMPLATE(BM_Reserve, Container<T>)->Apply(Sizes<T>);                       \
+    BENCHMARK_TEMPLATE(BM_InsertErase, Container<T>, Position::kFront)->Apply(InsertSizes<T>);  \
+    BENCHMARK_TEMPLATE(BM_InsertErase, Container<T>, Position::kMiddle)->Apply(InsertSizes<T>); \
+    BENCHMARK_TEMPLATE(BM_InsertErase, Container<T>, Position::kBack)->Apply(InsertSizes<T>);   \
+    BENCHMARK_TEMPLATE(BM_Iterate, Container<T>)->Apply(Sizes<T>)
+
+#define COPYABLE_VECTOR_BENCHMARKS(Container, T) \
+    VECTOR_BENCHMARKS(Container, T);             \
+    BENCHMARK_TEMPLATE(BM_CopyAssign, Container<T>)->Apply(Sizes<T>)
+
+#define ALL_VECTOR_BENCHMARKS(Container)              \
+    COPYABLE_VECTOR_BENCHMARKS(Container, int);       \
+    COPYABLE_VECTOR_BENCHMARKS(Container, Pod64);     \
+    COPYABLE_VECTOR_BENCHMARKS(Container, std::string); \
+    VECTOR_BENCHMARKS(Container, MoveOnly)
+
+ALL_VECTOR_BENCHMARKS(StdVector);
+ALL_VECTOR_BENCHMARKS(AdvancedVector);
+ALL_VECTOR_BENCHMARKS(AdvancedSmallVector);
+ALL_VECTOR_BENCHMARKS(AdvancedOneAndHalfVector);
+
+// Рост буфера на месте через realloc
+BENCHMARK_TEMPLATE(BM_PushBack, Vector<int, MallocAllocator<int>>)->Apply(Sizes<int>);
+BENCHMARK_TEMPLATE(BM_PushBack, Vector<Pod64, MallocAllocator<Pod64>>)->Apply(Sizes<Pod64>);
+BENCHMARK_TEMPLATE(BM_Reserve, Vector<Pod64, MallocAllocator<Pod64>>)->Apply(Sizes<Pod64>);
+
+// Рост сегментами: при росте переносится только таблица сегментов, а не элементы
+BENCHMARK_TEMPLATE(BM_PushBack, SegmentedVector<Pod64, BenchAllocator<Pod64>>)->Apply(Sizes<Pod64>);
+BENCHMARK_TEMPLATE(BM_PushBack, SegmentedVector<std::string, BenchAllocator<std::string>>)->Apply(Sizes<std::string>);
+BENCHMARK_TEMPLATE(BM_Iterate, SegmentedVector<int, BenchAllocator<int>>)->Apply(Sizes<int>);
+
+// Влияние политики роста на число выделений, пиковый объём памяти и незанятую вместимость
+template <typename Growth>
+void BM_GrowthPolicy(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    size_t wasted_bytes = 0;
+    AllocationCounters::Reset();
+    size_t copied = 0;
+    for (auto _ : state) {
+        AllocationCounters::released_bytes = 0;
+        Vector<int, BenchAllocator<int>, Growth> v;
+        for (size_t i = 0; i < n; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        wasted_bytes = (v.Capacity() - v.Size()) * sizeof(int);
+        benchmark::DoNotOptimize(v.begin());
+        copied += AllocationCounters::released_bytes;
+    }
+    ReportCounters(state, n, copied);
+    state.counters["peak_bytes"] = static_cast<double>(AllocationCounters::peak_bytes);
+    state.counters["wasted_bytes"] = static_cast<double>(wasted_bytes);
+}
+
+BENCHMARK_TEMPLATE(BM_GrowthPolicy, DoublingGrowth)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_GrowthPolicy, OneAndHalfGrowth)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_GrowthPolicy, CacheLineGrowth<>)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_GrowthPolicy, SizeClassGrowth<>)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_GrowthPolicy, SizeClassGrowth<OneAndHalfGrowth>)->Arg(1'000'000);
+
+// Число вызовов специальных функций-членов при PushBack в заполненный контейнер
+struct C {
+    C() noexcept {
+        ++def_ctor;
+    }
+    C(const C& /*other*/) noexcept {
+        ++copy_ctor;
+    }
+    C(C&& /*other*/) noexcept {
+        ++move_ctor;
+    }
+    C& operator=(const C& other) noexcept {
+        if (this != &other) {
+            ++copy_assign;
+        }
+        return *this;
+    }
+    C& operator=(C&& /*other*/) noexcept {
+        ++move_assign;
+        return *this;
+    }
+    ~C() {
+        ++dtor;
+    }
+
+    static void Reset() {
+        def_ctor = 0;
+        copy_ctor = 0;
+        move_ctor = 0;
+        copy_assign = 0;
+        move_assign = 0;
+        dtor = 0;
+    }
+
+    inline static size_t def_ctor = 0;
+    inline static size_t copy_ctor = 0;
+    inline static size_t move_ctor = 0;
+    inline static size_t copy_assign = 0;
+    inline static size_t move_assign = 0;
+    inline static size_t dtor = 0;
+};
+
+template <typename Container>
+void BM_SpecialMembers(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const C c;
+    C::Reset();
+    for (auto _ : state) {
+        Container v(n);
+        PushBack(v, C(c));
+        benchmark::DoNotOptimize(v.begin());
+    }
+    const auto iterations = static_cast<double>(state.iterations());
+    state.counters["def_ctors"] = static_cast<double>(C::def_ctor) / iterations;
+    state.counters["copy_ctors"] = static_cast<double>(C::copy_ctor) / iterations;
+    state.counters["move_ctors"] = static_cast<double>(C::move_ctor) / iterations;
+    state.counters["copy_assigns"] = static_cast<double>(C::copy_assign) / iterations;
+    state.counters["move_assigns"] = static_cast<double>(C::move_assign) / iterations;
+    state.counters["dtors"] = static_cast<double>(C::dtor) / iterations;
+}
+
+BENCHMARK_TEMPLATE(BM_SpecialMembers, std::vector<C>)->Arg(10);
+BENCHMARK_TEMPLATE(BM_SpecialMembers, Vector<C>)->Arg(10);
+
+// Добавление из многих потоков в общий контейнер: Vector под мьютексом против ConcurrentVector
+struct LockedVector {
+    void EmplaceBack(int value) {
+        std::lock_guard lock(mutex);
+        data.EmplaceBack(value);
+    }
+
+    std::mutex mutex;
+    Vector<int> data;
+};
+
+template <typename Container>
+void BM_ConcurrentAppend(benchmark::State& state) {
+    static std::unique_ptr<Container> shared;
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<Container>();
+    }
+    for (auto _ : state) {
+        shared->EmplaceBack(state.thread_index());
+    }
+    if (state.thread_index() == 0) {
+        shared.reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentAppend, LockedVector)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ConcurrentAppend, ConcurrentVector<int>)->ThreadRange(1, 64)->Iterations(1 << 18)->UseRealTime();
+
+// Создание и копирование больших векторов нетривиальных элементов в одном и нескольких потоках
+void BM_ConstructCopy(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Vector<std::string> v(n);
+        Vector<std::string> copy(v);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    ReportCounters(state, n);
+}
+
+void BM_ParallelConstructCopy(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        Vector<std::string> v(std::execution::par, n);
+        Vector<std::string> copy;
+        copy.Assign(std::execution::par, v.begin(), v.end());
+        copy.Clear(std::execution::par);
+        benchmark::DoNotOptimize(copy.begin());
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK(BM_ConstructCopy)->Arg(1 << 24)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelConstructCopy)->Arg(1 << 24)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Поиск отсутствующего значения, подсчёт и сумма: алгоритмы std против SIMD-ядер Vector
+enum class Scan {
+    kFind,
+    kCount,
+    kSum,
+};
+
+template <typename T, Scan Op>
+void BM_StdScan(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<T> v(n, T{1});
+    for (auto _ : state) {
+        if constexpr (Op == Scan::kFind) {
+            benchmark::DoNotOptimize(std::find(v.begin(), v.end(), T{2}));
+        } else if constexpr (Op == Scan::kCount) {
+            benchmark::DoNotOptimize(std::count(v.begin(), v.end(), T{1}));
+        } else {
+            benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), T{}));
+        }
+    }
+    ReportCounters(state, n);
+}
+
+template <typename T, Scan Op, typename Alloc = AlignedAllocator<T, 64>>
+void BM_VectorScan(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vector<T, Alloc> v(n);
+    v.Fill(T{1});
+    for (auto _ : state) {
+        if constexpr (Op == Scan::kFind) {
+            benchmark::DoNotOptimize(v.Find(T{2}));
+        } else if constexpr (Op == Scan::kCount) {
+            benchmark::DoNotOptimize(v.Count(T{1}));
+        } else {
+            benchmark::DoNotOptimize(v.Sum());
+        }
+    }
+    ReportCounters(state, n);
+}
+
+#define SCAN_BENCHMARKS(T)                                                         \
+    BENCHMARK_TEMPLATE(BM_StdScan, T, Scan::kFind)->Arg(1 << 16);                  \
+    BENCHMARK_TEMPLATE(BM_VectorScan, T, Scan::kFind)->Arg(1 << 16);               \
+    BENCHMARK_TEMPLATE(BM_StdScan, T, Scan::kCount)->Arg(1 << 16);                 \
+    BENCHMARK_TEMPLATE(BM_VectorScan, T, Scan::kCount)->Arg(1 << 16);              \
+    BENCHMARK_TEMPLATE(BM_StdScan, T, Scan::kSum)->Arg(1 << 16);                   \
+    BENCHMARK_TEMPLATE(BM_VectorScan, T, Scan::kSum)->Arg(1 << 16)
+
+SCAN_BENCHMARKS(int8_t);
+SCAN_BENCHMARKS(int32_t);
+SCAN_BENCHMARKS(float);
+
+// Обход буфера, не помещающегося в кеш: на huge pages меньше промахов TLB
+BENCHMARK_TEMPLATE(BM_VectorScan, int32_t, Scan::kSum)->Arg(1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_VectorScan, int32_t, Scan::kSum, HugePageAllocator<int32_t>)
+    ->Arg(1 << 26)
+    ->Unit(benchmark::kMillisecond);
+
+// Приёмник в память с виртуальным Write, как в прежних ручных циклах сериализации
+struct ByteSinkBase {
+    virtual ~ByteSinkBase() = default;
+    virtual void Write(const void* data, size_t bytes) = 0;
+};
+
+struct StringSink final : ByteSinkBase {
+    void Write(const void* data, size_t bytes) override {
+        out.append(static_cast<const char*>(data), bytes);
+    }
+
+    std::string out;
+};
+
+void BM_SerializeElementwise(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Vector<Pod64> v(n);
+    for (auto _ : state) {
+        StringSink sink;
+        sink.out.reserve(n * sizeof(Pod64) + 64);
+        ByteSinkBase& base = sink;
+        const uint64_t size = v.Size();
+        base.Write(&size, sizeof(size));
+        for (const Pod64& value : v) {
+            base.Write(&value, sizeof(value));
+        }
+        benchmark::DoNotOptimize(sink.out.data());
+    }
+    ReportCounters(state, n);
+}
+
+void BM_Serialize(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const Vector<Pod64> v(n);
+    for (auto _ : state) {
+        StringSink sink;
+        sink.out.reserve(n * sizeof(Pod64) + 64);
+        Serialize(v, sink);
+        benchmark::DoNotOptimize(sink.out.data());
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK(BM_SerializeElementwise)->Arg(1 << 16);
+BENCHMARK(BM_Serialize)->Arg(1 << 16);
+
+// Обход одного поля из десяти: записи целиком против столбца SoaVector
+struct Record {
+    int64_t id;
+    double price;
+    int64_t fields[8];
+};
+
+void BM_RecordFieldScan(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vector<Record> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i].price = static_cast<double>(i);
+    }
+    for (auto _ : state) {
+        double sum = 0;
+        for (const Record& record : v) {
+            sum += record.price;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportCounters(state, n);
+}
+
+void BM_SoaFieldScan(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    SoaVector<int64_t, double, std::array<int64_t, 8>> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v.Column<1>()[i] = static_cast<double>(i);
+    }
+    for (auto _ : state) {
+        double sum = 0;
+        for (const double price : v.Column<1>()) {
+            sum += price;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK(BM_RecordFieldScan)->Arg(1 << 20);
+BENCHMARK(BM_SoaFieldScan)->Arg(1 << 20);
+
+// Удаление каждого второго элемента по одному: сдвиг хвоста против переноса последнего
+template <bool Unordered>
+void BM_EraseEveryOther(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Vector<std::string> v(n);
+        state.ResumeTiming();
+        for (size_t i = 0; i < v.Size(); ++i) {
+            if constexpr (Unordered) {
+                v.EraseUnordered(v.begin() + i);
+            } else {
+                v.Erase(v.begin() + i);
+            }
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    ReportCounters(state, n / 2);
+}
+
+BENCHMARK_TEMPLATE(BM_EraseEveryOther, false)->Arg(1 << 14);
+BENCHMARK_TEMPLATE(BM_EraseEveryOther, true)->Arg(1 << 14);
+
+// Декодер дописывает каждое сообщение из 16 элементов: EmplaceBack проверяет вместимость
+// на каждом элементе, сеанс GrowBy — один раз на сообщение
+template <bool Session>
+void BM_AppendMessages(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    constexpr size_t kMessage = 16;
+    Vector<Pod64> v;
+    v.Reserve(n);
+    for (auto _ : state) {
+        v.Clear();
+        for (size_t i = 0; i < n; i += kMessage) {
+            if constexpr (Session) {
+                auto session = v.GrowBy(kMessage);
+                for (size_t j = 0; j < kMessage; ++j) {
+                    session.Emplace(MakeValue<Pod64>(i + j));
+                }
+            } else {
+                for (size_t j = 0; j < kMessage; ++j) {
+                    v.EmplaceBack(MakeValue<Pod64>(i + j));
+                }
+            }
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK_TEMPLATE(BM_AppendMessages, false)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_AppendMessages, true)->Arg(1 << 16);
+
+// Цена проверок границ в operator[]. В цикле до Size() компилятор убирает проверку,
+// при выборке по произвольным индексам она выполняется на каждом обращении
+template <typename Checking>
+void BM_IndexedSum(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vector<int, std::allocator<int>, DoublingGrowth, RawMemory<int>, NoStats, Checking> v(n);
+    std::iota(v.begin(), v.end(), 0);
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < v.Size(); ++i) {
+            sum += v[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportCounters(state, n);
+}
+
+template <typename Checking>
+void BM_IndexedGather(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Vector<int, std::allocator<int>, DoublingGrowth, RawMemory<int>, NoStats, Checking> v(n);
+    std::iota(v.begin(), v.end(), 0);
+    std::vector<size_t> indices(n);
+    for (size_t i = 0; i < n; ++i) {
+        indices[i] = i * 7919 % n;
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (const size_t index : indices) {
+            sum += v[index];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK_TEMPLATE(BM_IndexedSum, NoChecks)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_IndexedSum, BoundsChecks)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_IndexedGather, NoChecks)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_IndexedGather, BoundsChecks)->Arg(1 << 16);
+
+// Короткоживущий буфер из нескольких элементов, как в обработчике реального времени:
+// InplaceVector и SmallVector не обращаются к аллокатору
+template <typename Container>
+void BM_ShortLivedBuffer(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    AllocationCounters::Reset();
+    for (auto _ : state) {
+        Container v;
+        for (size_t i = 0; i < n; ++i) {
+            PushBack(v, MakeValue<int>(i));
+        }
+        benchmark::DoNotOptimize(v.begin());
+    }
+    ReportCounters(state, n);
+}
+
+BENCHMARK_TEMPLATE(BM_ShortLivedBuffer, std::vector<int, BenchAllocator<int>>)->Arg(24);
+BENCHMARK_TEMPLATE(BM_ShortLivedBuffer, Vector<int, BenchAllocator<int>>)->Arg(24);
+BENCHMARK_TEMPLATE(BM_ShortLivedBuffer, SmallVector<int, 32, BenchAllocator<int>>)->Arg(24);
+BENCHMARK_TEMPLATE(BM_ShortLivedBuffer, InplaceVector<int, 32>)->Arg(24);
+
+// Правки текста в редакторе: символы вставляются и удаляются у курсора, который изредка
+// сдвигается на несколько позиций. Vector сдвигает весь хвост, GapVector — только разрыв
+template <typename Container>
+void BM_EditorInsert(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    Container c = MakeFilled<Container>(n);
+    Reserve(c, n + 1);
+    size_t cursor = n / 2;
+    size_t step = 0;
+    AllocationCounters::Reset();
+    for (auto _ : state) {
+        if (++step % 64 == 0) {
+            cursor = (step / 64) % 2 == 0 ? cursor + 16 : cursor - 16;
+        }
+        InsertAt(c, cursor, MakeValue<int>(step));
+        EraseAt(c, cursor + 1);
+        benchmark::DoNotOptimize(&c);
+    }
+    ReportCounters(state, 1);
+}
+
+BENCHMARK_TEMPLATE(BM_EditorInsert, Vector<int, BenchAllocator<int>>)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_EditorInsert, GapVector<int, BenchAllocator<int>>)->Arg(1 << 16);
+
+// Загрузка файла из кэша страниц: Resize с обнулением, read во временный буфер и копирование
+// против ReadInto прямо в неинициализированный хвост вектора
+template <bool Direct>
+void BM_ReadFile(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    char path[] = "/tmp/vector_bench_XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        state.SkipWithError("mkstemp failed");
+        return;
+    }
+    unlink(path);
+    const Vector<std::byte> data(n);
+    if (write(fd, data.Data(), n) != static_cast<ssize_t>(n)) {
+        state.SkipWithError("write failed");
+        close(fd);
+        return;
+    }
+    Vector<std::byte> v;
+    v.Reserve(n);
+    Vector<std::byte> tmp;
+    for (auto _ : state) {
+        lseek(fd, 0, SEEK_SET);
+        v.Clear();
+        if constexpr (Direct) {
+            ReadInto(v, fd, n);
+        } else {
+            tmp.Resize(n);
+            [[maybe_unused]] const ssize_t got = read(fd, tmp.Data(), n);
+            v.Resize(n);
+            std::copy(tmp.begin(), tmp.end(), v.begin());
+        }
+        benchmark::DoNotOptimize(v.Data());
+    }
+    close(fd);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+
+BENCHMARK_TEMPLATE(BM_ReadFile, false)->Arg(16 << 20);
+BENCHMARK_TEMPLATE(BM_ReadFile, true)->Arg(16 << 20);
+
+// Поиск в таблице из n ключей, половина запросов — промахи. Узлы std::unordered_map разбросаны
+// по куче, у плоских таблиц ключи и значения лежат подряд
+template <typename Map>
+void BM_Lookup(benchmark::State& state) {
+    const auto n = static_cast<uint64_t>(state.range(0));
+    const auto key_of = [](uint64_t i) {
+        return i * 0x9E3779B97F4A7C15ULL >> 16;
+    };
+    Vector<std::pair<uint64_t, uint64_t>> items;
+    for (uint64_t i = 0; i < n; ++i) {
+        items.EmplaceBack(key_of(i), i);
+    }
+    // Плоские таблицы строятся из вектора целиком
+    Map map = [&] {
+        if constexpr (std::is_constructible_v<Map, Vector<std::pair<uint64_t, uint64_t>>>) {
+            return Map(std::move(items));
+        } else {
+            return Map(items.begin(), items.end());
+        }
+    }();
+    uint64_t i = 0;
+    for (auto _ : state) {
+        const uint64_t key = key_of(i % (2 * n));
+        if constexpr (requires { map.find(key); }) {
+            benchmark::DoNotOptimize(map.find(key) != map.end());
+        } else {
+            benchmark::DoNotOptimize(map.Find(key) != nullptr);
+        }
+        ++i;
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Lookup, std::unordered_map<uint64_t, uint64_t>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedFlatMap<uint64_t, uint64_t>)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, FlatHashMap<uint64_t, uint64_t>)->Arg(1 << 10)->Arg(1 << 20);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,14 @@
+#pragma once
+// Параллельные перегрузки Vector для стандартных политик выполнения.
+// В libstdc++ <execution> использует TBB, поэтому программу нужно компоновать с -ltbb
+#include "vector.h"
+
+#include <execution>
+
+template <>
+struct is_parallel_policy<std::execution::parallel_policy> : std::true_type {
+};
+
+template <>
+struct is_parallel_policy<std::execution::parallel_unsequenced_policy> : std::true_type {
+};
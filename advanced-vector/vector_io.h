@@ -0,0 +1,96 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
+// Чтение из файлового дескриптора прямо в неинициализированный хвост Vector: без обнуления
+// новых элементов (ResizeDefaultInit) и без промежуточного буфера. Поддерживаются только
+// тривиально копируемые элементы: их объекты создаются самими прочитанными байтами
+
+namespace detail {
+
+// Читает до bytes байт, повторяя read после частичного чтения и EINTR. Меньше bytes — конец файла
+inline size_t ReadFully(int fd, void* data, size_t bytes) {
+    size_t done = 0;
+    while (done < bytes) {
+        const ssize_t got = ::read(fd, static_cast<char*>(data) + done, bytes - done);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (got == 0) {
+            break;
+        }
+        done += static_cast<size_t>(got);
+    }
+    return done;
+}
+
+}  // namespace detail
+
+// Дописывает в конец v до count элементов, прочитанных из fd, и возвращает их число
+// (меньше count — конец файла). Размер вектора растёт только на целиком прочитанные элементы.
+// Если файл обрывается посреди элемента или read сообщает об ошибке, бросается исключение,
+// а вектор сохраняет элементы, прочитанные до неё
+template <typename T, typename... Params>
+size_t ReadInto(Vector<T, Params...>& v, int fd, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "ReadInto читает только тривиально копируемые элементы");
+    const size_t old_size = v.Size();
+    v.ResizeDefaultInit(old_size + count);
+    size_t bytes = 0;
+    try {
+        bytes = detail::ReadFully(fd, v.Data() + old_size, count * sizeof(T));
+    } catch (...) {
+        v.ResizeDefaultInit(old_size);
+        throw;
+    }
+    const size_t read = bytes / sizeof(T);
+    v.ResizeDefaultInit(old_size + read);
+    if (bytes % sizeof(T) != 0) {
+        throw std::runtime_error("ReadInto: truncated element");
+    }
+    return read;
+}
+
+// Читает fd до конца порциями не больше chunk_size элементов и передаёт их в on_chunk как
+// std::span<const T>. Порций две: пока on_chunk разбирает одну, следующая читается в другую
+// в фоновом потоке, поэтому разбор перекрывается с ожиданием ввода-вывода. Буферы порций
+// переиспользуются. Исключения чтения и on_chunk передаются вызывающему. Возвращает число элементов
+template <typename T, typename F>
+size_t ReadChunked(int fd, size_t chunk_size, F&& on_chunk) {
+    assert(chunk_size > 0);
+    Vector<T> current;
+    Vector<T> next;
+    current.Reserve(chunk_size);
+    next.Reserve(chunk_size);
+    auto read_next = [fd, chunk_size, &next] {
+        next.Clear();
+        return ReadInto(next, fd, chunk_size);
+    };
+    std::future<size_t> pending = std::async(std::launch::async, read_next);
+    size_t total = 0;
+    while (true) {
+        const size_t read = pending.get();
+        if (read == 0) {
+            return total;
+        }
+        total += read;
+        current.Swap(next);
+        // Неполная порция означает конец файла: следующее чтение вернёт 0 без ожидания
+        pending = std::async(read < chunk_size ? std::launch::deferred : std::launch::async, read_next);
+        // Если on_chunk бросит исключение, деструктор pending дождётся фонового чтения
+        on_chunk(std::span<const T>(current.Data(), current.Size()));
+    }
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Двоичная сериализация Vector. Приёмник — любой тип с методом Write(const void* data, size_t bytes),
+// источник — с методом Read(void* data, size_t bytes), возвращающим число прочитанных байт
+// (от 1 до bytes, 0 — в конце данных). Вызовы статические, без виртуальных функций.
+// Формат: заголовок с сигнатурой, размером элемента и числом элементов, затем элементы.
+// Тривиально копируемые элементы записываются и читаются одним блоком прямо в буфер вектора,
+// остальные — кодеком Codec<T>. Порядок байт — порядок машины, записавшей данные
+
+template <typename S>
+concept ByteSink = requires(S& sink, const void* data, size_t bytes) {
+    sink.Write(data, bytes);
+};
+
+template <typename S>
+concept ByteSource = requires(S& source, void* data, size_t bytes) {
+    { source.Read(data, bytes) } -> std::convertible_to<size_t>;
+};
+
+// Кодек нетривиально копируемого типа:
+//   template <ByteSink Sink> static void Encode(const T& value, Sink& sink);
+//   template <ByteSource Source> static T Decode(Source& source);
+template <typename T>
+struct Codec;
+
+namespace detail {
+
+inline constexpr uint32_t kSerializationMagic = 0x5643'4556;  // "VECV"
+
+// Числу элементов и длине строки из данных нельзя верить, пока данные не прочитаны: память под них
+// выделяется порциями не больше kMaxPreallocBytes по мере чтения, а не сразу по заголовку
+inline constexpr size_t kMaxPreallocBytes = size_t{1} << 20;
+
+template <typename T>
+inline constexpr size_t kMaxPreallocCount = std::max<size_t>(1, kMaxPreallocBytes / sizeof(T));
+
+struct SerializedHeader {
+    uint32_t magic = kSerializationMagic;
+    uint32_t elem_size = 0;  // sizeof(T) для тривиально копируемых элементов, 0 для кодека
+    uint64_t count = 0;
+};
+
+template <typename T>
+inline constexpr bool kRawSerializable = std::is_trivially_copyable_v<T>;
+
+template <typename T>
+constexpr uint32_t SerializedElemSize() noexcept {
+    return kRawSerializable<T> ? static_cast<uint32_t>(sizeof(T)) : 0;
+}
+
+// Источник может отдавать данные частями, как сокет
+template <ByteSource Source>
+void ReadExact(Source& source, void* data, size_t bytes) {
+    auto* dest = static_cast<std::byte*>(data);
+    while (bytes != 0) {
+        const auto read = static_cast<size_t>(source.Read(dest, bytes));
+        if (read == 0) {
+            throw std::runtime_error("Deserialize: unexpected end of data");
+        }
+        dest += read;
+        bytes -= read;
+    }
+}
+
+template <typename T, ByteSink Sink>
+void WritePod(Sink& sink, const T& value) {
+    sink.Write(&value, sizeof(T));
+}
+
+template <typename T, ByteSource Source>
+T ReadPod(Source& source) {
+    T value;
+    ReadExact(source, &value, sizeof(T));
+    return value;
+}
+
+template <typename T, ByteSink Sink>
+void WriteHeader(Sink& sink, size_t count) {
+    SerializedHeader header;
+    header.elem_size = SerializedElemSize<T>();
+    header.count = count;
+    WritePod(sink, header);
+}
+
+template <typename T, ByteSource Source>
+size_t ReadHeader(Source& source) {
+    const auto header = ReadPod<SerializedHeader>(source);
+    if (header.magic != kSerializationMagic) {
+        throw std::runtime_error("Deserialize: bad signature");
+    }
+    if (header.elem_size != SerializedElemSize<T>()) {
+        throw std::runtime_error("Deserialize: element type mismatch");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+template <typename T, ByteSink Sink>
+void WriteElements(Sink& sink, const T* data, size_t count) {
+    if constexpr (kRawSerializable<T>) {
+        if (count != 0) {
+            sink.Write(data, count * sizeof(T));
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            Codec<T>::Encode(data[i], sink);
+        }
+    }
+}
+
+// Дописывает count элементов в конец v порциями по kMaxPreallocCount. Если данные оборвутся
+// или кодек бросит исключение, прочитанные в этом вызове элементы не добавляются
+template <typename T, typename... Params, ByteSource Source>
+void ReadElements(Source& source, Vector<T, Params...>& v, size_t count) {
+    const size_t size = v.Size();
+    try {
+        for (size_t done = 0; done < count;) {
+            const size_t batch = std::min(count - done, kMaxPreallocCount<T>);
+            if constexpr (kRawSerializable<T>) {
+                v.ResizeDefaultInit(size + done + batch);
+                ReadExact(source, v.Data() + size + done, batch * sizeof(T));
+            } else {
+                auto session = v.GrowBy(batch);
+                for (size_t i = 0; i < batch; ++i) {
+                    session.Emplace(Codec<T>::Decode(source));
+                }
+            }
+            done += batch;
+        }
+    } catch (...) {
+        v.EraseRange(v.begin() + size, v.end());
+        throw;
+    }
+}
+
+// Вместимость под элементы из заголовка выделяется заранее, но не больше одной порции
+template <typename T, typename... Params, ByteSource Source>
+void ReadVector(Source& source, Vector<T, Params...>& v) {
+    const size_t count = ReadHeader<T>(source);
+    v.Reserve(v.Size() + std::min(count, kMaxPreallocCount<T>));
+    ReadElements(source, v, count);
+}
+
+}  // namespace detail
+
+template <typename T, typename... Params, ByteSink Sink>
+void Serialize(const Vector<T, Params...>& v, Sink& sink) {
+    detail::WriteHeader<T>(sink, v.Size());
+    detail::WriteElements(sink, v.Data(), v.Size());
+}
+
+// Vec — тип вектора-результата, например Vector<int>
+template <typename Vec, ByteSource Source>
+Vec Deserialize(Source& source) {
+    Vec v;
+    detail::ReadVector(source, v);
+    return v;
+}
+
+// Потоковое чтение: элементы читаются порциями не больше chunk_size и передаются в on_chunk
+// как std::span<T>, не дожидаясь остальных данных. Буфер порции переиспользуется,
+// поэтому элементы, нужные после возврата из on_chunk, следует скопировать или переместить.
+// Возвращает общее число элементов
+template <typename T, ByteSource Source, typename F>
+size_t DeserializeChunked(Source& source, size_t chunk_size, F&& on_chunk) {
+    assert(chunk_size > 0);
+    const size_t count = detail::ReadHeader<T>(source);
+    Vector<T> chunk;
+    chunk.Reserve(std::min(count, chunk_size));
+    for (size_t done = 0; done < count; done += chunk.Size()) {
+        chunk.Clear();
+        detail::ReadElements(source, chunk, std::min(count - done, chunk_size));
+        on_chunk(std::span<T>(chunk.Data(), chunk.Size()));
+    }
+    return count;
+}
+
+// Строки: длина, затем символы одним блоком
+template <typename CharT, typename Traits, typename A>
+struct Codec<std::basic_string<CharT, Traits, A>> {
+    using String = std::basic_string<CharT, Traits, A>;
+
+    template <ByteSink Sink>
+    static void Encode(const String& value, Sink& sink) {
+        detail::WritePod(sink, static_cast<uint64_t>(value.size()));
+        if (!value.empty()) {
+            sink.Write(value.data(), value.size() * sizeof(CharT));
+        }
+    }
+
+    // Длина из данных не проверена, поэтому строка растёт порциями по мере чтения
+    template <ByteSource Source>
+    static String Decode(Source& source) {
+        const auto size = static_cast<size_t>(detail::ReadPod<uint64_t>(source));
+        String value;
+        for (size_t done = 0; done < size;) {
+            const size_t batch = std::min(size - done, detail::kMaxPreallocCount<CharT>);
+            value.resize(done + batch);
+            detail::ReadExact(source, value.data() + done, batch * sizeof(CharT));
+            done += batch;
+        }
+        return value;
+    }
+};
+
+// Вложенные векторы: заголовок и элементы, как у вектора верхнего уровня
+template <typename T, typename... Params>
+struct Codec<Vector<T, Params...>> {
+    template <ByteSink Sink>
+    static void Encode(const Vector<T, Params...>& value, Sink& sink) {
+        Serialize(value, sink);
+    }
+
+    template <ByteSource Source>
+    static Vector<T, Params...> Decode(Source& source) {
+        return Deserialize<Vector<T, Params...>>(source);
+    }
+};
+
+// Приёмник и источник поверх потоков ввода-вывода
+class OstreamSink {
+public:
+    explicit OstreamSink(std::ostream& out) noexcept
+        : out_(out) {
+    }
+
+    void Write(const void* data, size_t bytes) {
+        if (!out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes))) {
+            throw std::runtime_error("Serialize: write failed");
+        }
+    }
+
+private:
+    std::ostream& out_;
+};
+
+class IstreamSource {
+public:
+    explicit IstreamSource(std::istream& in) noexcept
+        : in_(in) {
+    }
+
+    size_t Read(void* data, size_t bytes) {
+        in_.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        return static_cast<size_t>(in_.gcount());
+    }
+
+private:
+    std::istream& in_;
+};
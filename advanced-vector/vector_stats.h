@@ -0,0 +1,248 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <source_location>
+#include <vector>
+
+// Способ, которым элементы переносятся в новый буфер при росте вектора
+enum class RelocationKind {
+    kMemcpy,  // тривиально перемещаемые элементы, одним memcpy
+    kMove,    // перемещающим конструктором
+    kCopy,    // копирующим конструктором: перемещение может бросить исключение
+};
+
+// Снимок статистики вектора или всех векторов одного места создания. Объёмы указаны в байтах
+struct VectorStatsSnapshot {
+    size_t allocations = 0;          // выделено новых буферов
+    size_t allocated_bytes = 0;
+    size_t reallocations = 0;        // буферов изменено на месте (realloc, mremap)
+    size_t relocated_bytes = 0;      // перенесено элементов в новые буферы в Reserve, Emplace и вставках
+    size_t memcpy_relocations = 0;   // число переносов каждым из способов RelocationKind
+    size_t move_relocations = 0;
+    size_t copy_relocations = 0;
+    size_t peak_capacity_bytes = 0;  // наибольшая вместимость одного вектора
+    size_t capacity_bytes = 0;       // текущая вместимость
+    size_t wasted_bytes = 0;         // вместимость, не занятая элементами
+};
+
+// Политика статистики получает от Vector события:
+//   OnAllocate(bytes)                            — выделен новый буфер
+//   OnReallocate(bytes)                          — размер буфера изменён на месте
+//   OnRelocate(bytes, kind)                      — элементы перенесены в новый буфер
+//   OnCapacityChange(capacity_bytes, size_bytes) — вектор сменил буфер или вместимость
+// и возвращает VectorStatsSnapshot из Snapshot(capacity_bytes, size_bytes).
+// Копия политики начинает учёт заново: счётчики принадлежат экземпляру вектора
+
+// Статистика не собирается. Пустые обработчики полностью удаляются компилятором
+struct NoStats {
+    constexpr void OnAllocate(size_t /*bytes*/) noexcept {
+    }
+
+    constexpr void OnReallocate(size_t /*bytes*/) noexcept {
+    }
+
+    constexpr void OnRelocate(size_t /*bytes*/, RelocationKind /*kind*/) noexcept {
+    }
+
+    constexpr void OnCapacityChange(size_t /*capacity_bytes*/, size_t /*size_bytes*/) noexcept {
+    }
+
+    constexpr VectorStatsSnapshot Snapshot(size_t /*capacity_bytes*/, size_t /*size_bytes*/) const noexcept {
+        return {};
+    }
+};
+
+// Счётчики внутри каждого вектора
+class VectorStats {
+public:
+    VectorStats() = default;
+
+    VectorStats(const VectorStats& /*other*/) noexcept {
+    }
+
+    VectorStats& operator=(const VectorStats& other) = delete;
+
+    void OnAllocate(size_t bytes) noexcept {
+        ++stats_.allocations;
+        stats_.allocated_bytes += bytes;
+    }
+
+    void OnReallocate(size_t /*bytes*/) noexcept {
+        ++stats_.reallocations;
+    }
+
+    void OnRelocate(size_t bytes, RelocationKind kind) noexcept {
+        stats_.relocated_bytes += bytes;
+        switch (kind) {
+            case RelocationKind::kMemcpy: ++stats_.memcpy_relocations; break;
+            case RelocationKind::kMove: ++stats_.move_relocations; break;
+            case RelocationKind::kCopy: ++stats_.copy_relocations; break;
+        }
+    }
+
+    void OnCapacityChange(size_t capacity_bytes, size_t /*size_bytes*/) noexcept {
+        stats_.peak_capacity_bytes = std::max(stats_.peak_capacity_bytes, capacity_bytes);
+    }
+
+    VectorStatsSnapshot Snapshot(size_t capacity_bytes, size_t size_bytes) const noexcept {
+        VectorStatsSnapshot result = stats_;
+        result.peak_capacity_bytes = std::max(result.peak_capacity_bytes, capacity_bytes);
+        result.capacity_bytes = capacity_bytes;
+        result.wasted_bytes = capacity_bytes - size_bytes;
+        return result;
+    }
+
+private:
+    VectorStatsSnapshot stats_;
+};
+
+// Статистика одного места создания
+struct CallSiteSnapshot {
+    std::source_location location;
+    VectorStatsSnapshot stats;
+};
+
+// Общие счётчики для всех векторов, созданных в одном месте программы.
+// Текущие вместимость и незанятое место суммируются по живым векторам
+// на момент последнего изменения вместимости каждого из них
+class CallSiteStats {
+    struct Counters {
+        explicit Counters(const std::source_location& loc) noexcept
+            : location(loc) {
+        }
+
+        std::source_location location;
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> allocated_bytes{0};
+        std::atomic<size_t> reallocations{0};
+        std::atomic<size_t> relocated_bytes{0};
+        std::atomic<size_t> memcpy_relocations{0};
+        std::atomic<size_t> move_relocations{0};
+        std::atomic<size_t> copy_relocations{0};
+        std::atomic<size_t> peak_capacity_bytes{0};
+        std::atomic<size_t> capacity_bytes{0};
+        std::atomic<size_t> size_bytes{0};
+    };
+
+public:
+    // Вектор не относится ни к одному месту, события не учитываются
+    CallSiteStats() = default;
+
+    // Статистика места вызова. Векторы, созданные в одном месте, делят счётчики
+    static CallSiteStats Here(std::source_location location = std::source_location::current()) {
+        return CallSiteStats(&Register(location));
+    }
+
+    CallSiteStats(const CallSiteStats& other) noexcept
+        : site_(other.site_) {
+    }
+
+    CallSiteStats& operator=(const CallSiteStats& other) = delete;
+
+    void OnAllocate(size_t bytes) noexcept {
+        if (site_) {
+            site_->allocations.fetch_add(1, std::memory_order_relaxed);
+            site_->allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    void OnReallocate(size_t /*bytes*/) noexcept {
+        if (site_) {
+            site_->reallocations.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void OnRelocate(size_t bytes, RelocationKind kind) noexcept {
+        if (!site_) {
+            return;
+        }
+        site_->relocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        switch (kind) {
+            case RelocationKind::kMemcpy: site_->memcpy_relocations.fetch_add(1, std::memory_order_relaxed); break;
+            case RelocationKind::kMove: site_->move_relocations.fetch_add(1, std::memory_order_relaxed); break;
+            case RelocationKind::kCopy: site_->copy_relocations.fetch_add(1, std::memory_order_relaxed); break;
+        }
+    }
+
+    // Вклад вектора в суммы места обновляется разностью с последними сообщёнными значениями
+    void OnCapacityChange(size_t capacity_bytes, size_t size_bytes) noexcept {
+        if (!site_) {
+            return;
+        }
+        site_->capacity_bytes.fetch_add(capacity_bytes - reported_capacity_bytes_, std::memory_order_relaxed);
+        site_->size_bytes.fetch_add(size_bytes - reported_size_bytes_, std::memory_order_relaxed);
+        reported_capacity_bytes_ = capacity_bytes;
+        reported_size_bytes_ = size_bytes;
+        size_t peak = site_->peak_capacity_bytes.load(std::memory_order_relaxed);
+        while (peak < capacity_bytes
+               && !site_->peak_capacity_bytes.compare_exchange_weak(peak, capacity_bytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Снимок общих счётчиков места, к которому относится вектор
+    VectorStatsSnapshot Snapshot(size_t /*capacity_bytes*/, size_t /*size_bytes*/) const noexcept {
+        return site_ ? Load(*site_) : VectorStatsSnapshot{};
+    }
+
+    // Снимки всех мест, в которых создавались векторы со статистикой
+    static std::vector<CallSiteSnapshot> Collect() {
+        std::lock_guard lock(Mutex());
+        std::vector<CallSiteSnapshot> result;
+        result.reserve(Sites().size());
+        for (const Counters& site : Sites()) {
+            result.push_back({site.location, Load(site)});
+        }
+        return result;
+    }
+
+private:
+    explicit CallSiteStats(Counters* site) noexcept
+        : site_(site) {
+    }
+
+    // Мест создания немного, поэтому достаточно линейного поиска
+    static Counters& Register(const std::source_location& location) {
+        std::lock_guard lock(Mutex());
+        for (Counters& site : Sites()) {
+            if (site.location.line() == location.line() && site.location.column() == location.column()
+                && std::strcmp(site.location.file_name(), location.file_name()) == 0) {
+                return site;
+            }
+        }
+        return Sites().emplace_back(location);
+    }
+
+    static VectorStatsSnapshot Load(const Counters& site) noexcept {
+        VectorStatsSnapshot result;
+        result.allocations = site.allocations.load(std::memory_order_relaxed);
+        result.allocated_bytes = site.allocated_bytes.load(std::memory_order_relaxed);
+        result.reallocations = site.reallocations.load(std::memory_order_relaxed);
+        result.relocated_bytes = site.relocated_bytes.load(std::memory_order_relaxed);
+        result.memcpy_relocations = site.memcpy_relocations.load(std::memory_order_relaxed);
+        result.move_relocations = site.move_relocations.load(std::memory_order_relaxed);
+        result.copy_relocations = site.copy_relocations.load(std::memory_order_relaxed);
+        result.peak_capacity_bytes = site.peak_capacity_bytes.load(std::memory_order_relaxed);
+        result.capacity_bytes = site.capacity_bytes.load(std::memory_order_relaxed);
+        result.wasted_bytes = result.capacity_bytes - site.size_bytes.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    // Узлы списка не перемещаются, поэтому векторы хранят указатели на свои счётчики
+    static std::list<Counters>& Sites() {
+        static std::list<Counters> sites;
+        return sites;
+    }
+
+    static std::mutex& Mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    Counters* site_ = nullptr;
+    size_t reported_capacity_bytes_ = 0;
+    size_t reported_size_bytes_ = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+// Неизменяемое представление элементов, лежащих в памяти подряд: заимствованный указатель и размер.
+// Передаётся по значению вместо const Vector& или копии части вектора; владелец элементов должен
+// пережить представление и не перевыделять память, пока оно используется
+template <typename T>
+class VectorView {
+public:
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    constexpr VectorView() = default;
+
+    constexpr VectorView(const T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    constexpr VectorView(std::span<const T> span) noexcept
+        : VectorView(span.data(), span.size()) {
+    }
+
+    template <typename Alloc, typename Growth, typename Storage, typename Stats, typename Checking>
+    constexpr VectorView(const Vector<T, Alloc, Growth, Storage, Stats, Checking>& vector) noexcept
+        : VectorView(vector.Data(), vector.Size()) {
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return data_;
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Элементы [offset, offset + count); по умолчанию — до конца представления
+    constexpr VectorView Subview(size_t offset, size_t count = std::dynamic_extent) const noexcept {
+        assert(offset <= size_);
+        if (count == std::dynamic_extent) {
+            count = size_ - offset;
+        }
+        assert(count <= size_ - offset);
+        return {data_ + offset, count};
+    }
+
+    constexpr operator std::span<const T>() const noexcept {
+        return {data_, size_};
+    }
+
+    // Для арифметических T поиск и подсчёт выполняют SIMD-ядра, как у Vector
+    constexpr const_iterator Find(const T& value) const {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return data_ + detail::simd::Find<alignof(T)>(data_, size_, value);
+            }
+        }
+        return std::find(begin(), end(), value);
+    }
+
+    constexpr size_t Count(const T& value) const {
+        if constexpr (detail::simd::kSupported<T>) {
+            if (!std::is_constant_evaluated()) {
+                return detail::simd::Count<alignof(T)>(data_, size_, value);
+            }
+        }
+        return static_cast<size_t>(std::count(begin(), end(), value));
+    }
+
+    friend constexpr bool operator==(VectorView lhs, VectorView rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename T, typename Alloc, typename Growth, typename Storage, typename Stats, typename Checking>
+VectorView(const Vector<T, Alloc, Growth, Storage, Stats, Checking>&) -> VectorView<T>;